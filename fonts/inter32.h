@@ -121,6 +121,59 @@ constexpr CharData char_data[] = {
 
 constexpr int char_count = 97;
 
+// Glyph drawn for codepoints the font lacks: '?', else ' ', else -1
+constexpr int fallback_index = 31;
+
+// char_data index for codepoints below direct_count; missing ones hold fallback_index
+constexpr uint32_t direct_count = 256;
+constexpr int16_t direct_index[direct_count] = {
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+    80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    95, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 96, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31
+};
+
+// Codepoints from direct_count up, sorted for binary search
+struct OverflowGlyph {
+    uint32_t codepoint;
+    int16_t index;
+};
+
+constexpr int overflow_count = 0;
+constexpr OverflowGlyph overflow_index[] = {
+    {0xFFFFFFFF, -1}  // Sentinel; keeps the array non-empty
+};
+
+// char_data index for a codepoint, or fallback_index if the font lacks it
+constexpr int glyph_index(uint32_t codepoint) {
+    if (codepoint < direct_count) {
+        return direct_index[codepoint];
+    }
+    int lo = 0;
+    int hi = overflow_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (overflow_index[mid].codepoint < codepoint) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < overflow_count && overflow_index[lo].codepoint == codepoint) ? overflow_index[lo].index : fallback_index;
+}
+
 const uint8_t atlas_data[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -4221,6 +4274,22 @@ const uint8_t atlas_data[] = {
 
 };
 
-} // namespace font_Inter_Regular_20
+// Atlas, metrics and glyph table for the text code in src/text_layout.h
+struct Font {
+    using Glyph = CharData;
+    static constexpr int size = font_Inter_Regular_32::size;
+    static constexpr int line_height = font_Inter_Regular_32::line_height;
+    static constexpr int baseline = font_Inter_Regular_32::baseline;
+    static constexpr int atlas_width = font_Inter_Regular_32::atlas_width;
+    static constexpr int atlas_height = font_Inter_Regular_32::atlas_height;
+    static const uint8_t* atlas() { return atlas_data; }
+    // Glyph for a codepoint, or the fallback glyph; nullptr if the font has neither
+    static constexpr const Glyph* glyph(uint32_t codepoint) {
+        int index = glyph_index(codepoint);
+        return index >= 0 ? &char_data[index] : nullptr;
+    }
+};
+
+} // namespace font_Inter_Regular_32
 
 #endif // INTER_REGULAR_32_H
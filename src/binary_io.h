@@ -0,0 +1,109 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Little-endian fixed-width encoding shared by the on-disk binary formats.
+ * Strings carry a 16-bit length; blobs carry a 32-bit length.
+ */
+
+inline uint32_t fnv1a(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class BinaryWriter {
+public:
+    void u16(uint16_t value) { put(value, 2); }
+    void u32(uint32_t value) { put(value, 4); }
+    void i32(int32_t value) { put(static_cast<uint32_t>(value), 4); }
+    void i64(int64_t value) { put(static_cast<uint64_t>(value), 8); }
+
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put(bits, 8);
+    }
+
+    void str(const std::string& value) {
+        size_t length = std::min<size_t>(value.size(), UINT16_MAX);
+        u16(static_cast<uint16_t>(length));
+        bytes.insert(bytes.end(), value.begin(), value.begin() + length);
+    }
+
+    void blob(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        bytes.insert(bytes.end(), value.begin(), value.end());
+    }
+
+    std::vector<uint8_t> bytes;
+
+private:
+    void put(uint64_t value, int width) {
+        for (int i = 0; i < width; i++) {
+            bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+};
+
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t* data, size_t length) : data_(data), length_(length), pos_(0), ok_(true) {}
+
+    uint16_t u16() { return static_cast<uint16_t>(get(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(get(4)); }
+    int32_t i32() { return static_cast<int32_t>(get(4)); }
+    int64_t i64() { return static_cast<int64_t>(get(8)); }
+
+    double f64() {
+        uint64_t bits = get(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string str() { return take(u16()); }
+    std::string blob() { return take(u32()); }
+
+    bool ok() const { return ok_; }
+
+private:
+    uint64_t get(int width) {
+        if (!ok_ || pos_ + width > length_) {
+            ok_ = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < width; i++) {
+            value |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+        }
+        pos_ += width;
+        return value;
+    }
+
+    std::string take(size_t length) {
+        if (!ok_ || pos_ + length > length_) {
+            ok_ = false;
+            return "";
+        }
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_;
+    bool ok_;
+};
+
+#endif // BINARY_IO_H
@@ -0,0 +1,105 @@
+#include "body_stream.h"
+#include <exception>
+
+BodyStream::BodyStream(size_t capacity)
+    : capacity_(capacity)
+    , buffered_(0)
+    , closed_(false)
+    , reader_done_(false)
+{
+}
+
+void BodyStream::write(const char* data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A chunk larger than the capacity is still accepted into an empty pipe
+    changed_.wait(lock, [&] { return reader_done_ || buffered_ == 0 || buffered_ + length <= capacity_; });
+    if (reader_done_) {
+        return;
+    }
+    chunks_.emplace_back(data, length);
+    buffered_ += length;
+    changed_.notify_all();
+}
+
+void BodyStream::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    changed_.notify_all();
+}
+
+void BodyStream::finishReading() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reader_done_ = true;
+    chunks_.clear();
+    buffered_ = 0;
+    changed_.notify_all();
+}
+
+BodyStream::int_type BodyStream::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return !chunks_.empty() || closed_ || reader_done_; });
+    if (chunks_.empty() || reader_done_) {
+        return traits_type::eof();
+    }
+    
+    current_ = std::move(chunks_.front());
+    chunks_.pop_front();
+    buffered_ -= current_.size();
+    changed_.notify_all();
+    
+    char* begin = &current_[0];
+    setg(begin, begin, begin + current_.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+StreamingParse::~StreamingParse() {
+    join();
+}
+
+void StreamingParse::join() {
+    if (thread_.joinable()) {
+        stream_->close();
+        thread_.join();
+    }
+}
+
+BodyStream* StreamingParse::start() {
+    join();
+    
+    ok_ = false;
+    error_.clear();
+    stream_ = std::make_unique<BodyStream>();
+    BodyStream* stream = stream_.get();
+    thread_ = std::thread([this, stream]() {
+        std::istream input(stream);
+        try {
+            ok_ = parse_(input, error_);
+        } catch (const std::exception& e) {
+            ok_ = false;
+            error_ = e.what();
+        }
+        // Whatever the parser left unread is discarded as it arrives
+        stream->finishReading();
+    });
+    return stream;
+}
+
+bool StreamingParse::finish(std::string& error) {
+    if (!stream_) {
+        error = "No response body";
+        return false;
+    }
+    join();
+    if (!ok_) {
+        error = error_;
+    }
+    return ok_;
+}
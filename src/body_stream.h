@@ -0,0 +1,80 @@
+#ifndef BODY_STREAM_H
+#define BODY_STREAM_H
+
+#include <streambuf>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <thread>
+#include <cstddef>
+
+/**
+ * Bounded pipe from a response body being received to a parser reading
+ * it through std::istream. The writer blocks while capacity bytes are
+ * waiting, so memory stays bounded however large the body is, and the
+ * parser runs on the first chunk instead of after the last.
+ */
+class BodyStream : public std::streambuf {
+public:
+    explicit BodyStream(size_t capacity = 64 * 1024);
+
+    // Writer side. Blocks while the pipe is full. Once the reader has
+    // finished, the data is dropped and the call returns immediately.
+    void write(const char* data, size_t length);
+
+    // End of body; the reader sees EOF after the buffered data
+    void close();
+
+    // Reader side: stop consuming; later writes are discarded
+    void finishReading();
+
+protected:
+    int_type underflow() override;
+
+private:
+    size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::string> chunks_;
+    size_t buffered_;
+    bool closed_;
+    bool reader_done_;
+
+    std::string current_;  // Chunk the reader is working through
+};
+
+/**
+ * Runs a parser on its own thread, reading from a BodyStream that the
+ * receiving side writes into. start() may be called again if the request
+ * is re-sent; the earlier run is abandoned.
+ */
+class StreamingParse {
+public:
+    using Parse = std::function<bool(std::istream& input, std::string& error)>;
+
+    explicit StreamingParse(Parse parse) : parse_(std::move(parse)), ok_(false) {}
+    ~StreamingParse();
+
+    // Start a parser thread; the returned stream is fed until close()
+    BodyStream* start();
+
+    // Wait for the parser once its stream is closed. False if it failed or
+    // was never started.
+    bool finish(std::string& error);
+
+private:
+    void join();
+
+    Parse parse_;
+    std::unique_ptr<BodyStream> stream_;
+    std::thread thread_;
+    bool ok_;
+    std::string error_;
+};
+
+#endif // BODY_STREAM_H
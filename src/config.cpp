@@ -40,6 +40,53 @@ bool Config::load_from_file(const std::string& config_path) {
             timezone = config_json["timezone"];
         }
         
+        if (config_json.contains("compressed_transfer")) {
+            compressed_transfer = config_json["compressed_transfer"];
+        }
+        
+        if (config_json.contains("endpoint_cache_file")) {
+            endpoint_cache_file = config_json["endpoint_cache_file"];
+        }
+        
+        if (config_json.contains("endpoint_revalidate_hours")) {
+            endpoint_revalidate_hours = config_json["endpoint_revalidate_hours"];
+        }
+        
+        if (config_json.contains("hourly_forecast")) {
+            hourly_forecast = config_json["hourly_forecast"];
+        }
+        
+        if (config_json.contains("snapshot_file")) {
+            snapshot_file = config_json["snapshot_file"];
+        }
+        
+        if (config_json.contains("api_base_url")) {
+            api_base_url = config_json["api_base_url"];
+        }
+        
+        if (config_json.contains("observation_ttl_minutes")) {
+            observation_ttl_minutes = config_json["observation_ttl_minutes"];
+        }
+        
+        if (config_json.contains("forecast_ttl_minutes")) {
+            forecast_ttl_minutes = config_json["forecast_ttl_minutes"];
+        }
+        
+        if (config_json.contains("max_response_kb")) {
+            max_response_kb = config_json["max_response_kb"];
+        }
+        
+        if (config_json.contains("locations")) {
+            locations.clear();
+            for (const auto& entry : config_json["locations"]) {
+                LocationConfig location;
+                location.name = entry.value("name", "");
+                location.latitude = entry.at("latitude");
+                location.longitude = entry.at("longitude");
+                locations.push_back(location);
+            }
+        }
+        
         std::cout << "Loaded configuration from " << config_path << std::endl;
         return true;
         
@@ -58,6 +105,23 @@ bool Config::save_to_file(const std::string& config_path) const {
         config_json["use_real_api"] = use_real_api;
         config_json["use_sdl_emulator"] = use_sdl_emulator;
         config_json["timezone"] = timezone;
+        config_json["compressed_transfer"] = compressed_transfer;
+        config_json["endpoint_cache_file"] = endpoint_cache_file;
+        config_json["endpoint_revalidate_hours"] = endpoint_revalidate_hours;
+        config_json["hourly_forecast"] = hourly_forecast;
+        config_json["snapshot_file"] = snapshot_file;
+        config_json["api_base_url"] = api_base_url;
+        config_json["observation_ttl_minutes"] = observation_ttl_minutes;
+        config_json["forecast_ttl_minutes"] = forecast_ttl_minutes;
+        config_json["max_response_kb"] = max_response_kb;
+        config_json["locations"] = json::array();
+        for (const auto& location : locations) {
+            config_json["locations"].push_back({
+                {"name", location.name},
+                {"latitude", location.latitude},
+                {"longitude", location.longitude}
+            });
+        }
         
         std::ofstream file(config_path);
         if (!file.is_open()) {
@@ -1,6 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+struct LocationConfig {
+    std::string name;
+    double latitude = 0;
+    double longitude = 0;
+};
 
 struct Config {
     std::string location_name = "Round Rock, TX";
@@ -9,6 +16,18 @@ struct Config {
     bool use_real_api = true;
     bool use_sdl_emulator = true;
     std::string timezone = "America/Chicago";  // Default to Central Time
+    bool compressed_transfer = false;  // Request gzip/deflate responses from NWS
+    std::string endpoint_cache_file = "endpoint_cache.json";  // Resolved NWS endpoints; empty disables
+    int endpoint_revalidate_hours = 24;  // Background re-resolution interval
+    bool hourly_forecast = false;  // Ingest /forecast/hourly for hourly panels
+    std::string snapshot_file = "weather_snapshot.bin";  // Last good weather data for boot; empty disables
+    std::string api_base_url = "https://api.weather.gov";  // Point at mock_nws_server for offline runs
+    int observation_ttl_minutes = 10;  // Refetch observations once this old
+    int forecast_ttl_minutes = 60;     // Refetch gridpoint, text and hourly forecasts once this old
+    int max_response_kb = 4096;        // Abort NWS responses larger than this once decoded
+    // Several locations fetched together, sharing grid and station requests;
+    // replaces latitude/longitude when set, and button C cycles the display
+    std::vector<LocationConfig> locations;
     
     // Load configuration from JSON file
     bool load_from_file(const std::string& config_path);
@@ -0,0 +1,107 @@
+#include "connection_pool.h"
+#include <httplib.h>
+
+ConnectionPool::Lease::Lease(ConnectionPool* pool, std::unique_ptr<httplib::Client> client)
+    : pool_(pool)
+    , client_(std::move(client))
+{
+}
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_)
+    , client_(std::move(other.client_))
+{
+    other.pool_ = nullptr;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (pool_ && client_) {
+        pool_->release(std::move(client_));
+    }
+}
+
+bool ConnectionPool::Lease::isConnected() const {
+    return client_ && client_->is_socket_open();
+}
+
+void ConnectionPool::Lease::reset() {
+    if (client_) {
+        client_->stop();
+    }
+}
+
+ConnectionPool::ConnectionPool(const std::string& base_url, size_t max_idle)
+    : base_url_(base_url)
+    , max_idle_(max_idle)
+    , timeout_seconds_(10)
+    , requests_(0)
+    , connections_opened_(0)
+    , connections_reused_(0)
+    , reconnects_(0)
+{
+}
+
+ConnectionPool::~ConnectionPool() {
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            auto client = std::move(idle_.back());
+            idle_.pop_back();
+            return Lease(this, std::move(client));
+        }
+    }
+
+    return Lease(this, createClient());
+}
+
+void ConnectionPool::setTimeout(int timeout_seconds) {
+    timeout_seconds_ = timeout_seconds;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& client : idle_) {
+        client->set_connection_timeout(timeout_seconds);
+        client->set_read_timeout(timeout_seconds);
+    }
+}
+
+void ConnectionPool::recordRequest(bool reused) {
+    requests_++;
+    if (reused) {
+        connections_reused_++;
+    } else {
+        connections_opened_++;
+    }
+}
+
+void ConnectionPool::recordReconnect() {
+    reconnects_++;
+}
+
+ConnectionStats ConnectionPool::getStats() const {
+    ConnectionStats stats;
+    stats.requests = requests_;
+    stats.connections_opened = connections_opened_;
+    stats.connections_reused = connections_reused_;
+    stats.reconnects = reconnects_;
+    return stats;
+}
+
+std::unique_ptr<httplib::Client> ConnectionPool::createClient() const {
+    auto client = std::make_unique<httplib::Client>(base_url_);
+    client->set_connection_timeout(timeout_seconds_);
+    client->set_read_timeout(timeout_seconds_);
+    client->set_follow_location(true);
+    client->set_keep_alive(true);
+    return client;
+}
+
+void ConnectionPool::release(std::unique_ptr<httplib::Client> client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < max_idle_) {
+        idle_.push_back(std::move(client));
+    }
+    // Otherwise the client is dropped and its socket closed
+}
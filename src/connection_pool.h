@@ -0,0 +1,84 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace httplib {
+class Client;
+}
+
+// Connection reuse counters, used to confirm the TLS handshake is paid once
+struct ConnectionStats {
+    uint64_t requests = 0;            // Requests issued through the pool
+    uint64_t connections_opened = 0;  // Requests that had to open a new socket
+    uint64_t connections_reused = 0;  // Requests served on an already-open socket
+    uint64_t reconnects = 0;          // Stale sockets detected and reopened
+};
+
+/**
+ * Small pool of keep-alive HTTP clients for a single host.
+ * Each pooled client owns one persistent connection that survives across
+ * requests and refresh cycles. Callers lease a client for one request and
+ * the lease hands it back to the pool when it goes out of scope.
+ */
+class ConnectionPool {
+public:
+    class Lease {
+    public:
+        Lease(ConnectionPool* pool, std::unique_ptr<httplib::Client> client);
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        httplib::Client& client() { return *client_; }
+
+        // True if the leased client currently holds an open socket
+        bool isConnected() const;
+
+        // Close the socket so the next request reconnects
+        void reset();
+
+    private:
+        ConnectionPool* pool_;
+        std::unique_ptr<httplib::Client> client_;
+    };
+
+    explicit ConnectionPool(const std::string& base_url, size_t max_idle = 4);
+    ~ConnectionPool();
+
+    // Lease an idle client, or create a new one if none are available
+    Lease acquire();
+
+    // Timeouts apply to clients created after the call as well as idle ones
+    void setTimeout(int timeout_seconds);
+
+    // Counters
+    void recordRequest(bool reused);
+    void recordReconnect();
+    ConnectionStats getStats() const;
+
+private:
+    std::unique_ptr<httplib::Client> createClient() const;
+    void release(std::unique_ptr<httplib::Client> client);
+
+    std::string base_url_;
+    size_t max_idle_;
+    std::atomic<int> timeout_seconds_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<httplib::Client>> idle_;
+
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> connections_opened_;
+    std::atomic<uint64_t> connections_reused_;
+    std::atomic<uint64_t> reconnects_;
+};
+
+#endif // CONNECTION_POOL_H
@@ -0,0 +1,129 @@
+#include "content_decoder.h"
+#include <algorithm>
+#include <cctype>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Decoded output is produced in chunks of this size
+static constexpr size_t DECODE_CHUNK_SIZE = 16 * 1024;
+
+struct ContentDecoder::ZlibState {
+#ifdef HAVE_ZLIB
+    z_stream stream = {};
+    bool initialized = false;
+    bool finished = false;
+#endif
+};
+
+ContentDecoder::ContentDecoder(Encoding encoding)
+    : encoding_(encoding)
+{
+#ifdef HAVE_ZLIB
+    if (encoding_ == Encoding::Gzip || encoding_ == Encoding::Deflate) {
+        zlib_ = std::make_unique<ZlibState>();
+        // 15 + 32 lets zlib detect either a gzip or a zlib header
+        if (inflateInit2(&zlib_->stream, 15 + 32) == Z_OK) {
+            zlib_->initialized = true;
+        }
+    }
+#endif
+}
+
+ContentDecoder::~ContentDecoder() {
+#ifdef HAVE_ZLIB
+    if (zlib_ && zlib_->initialized) {
+        inflateEnd(&zlib_->stream);
+    }
+#endif
+}
+
+ContentDecoder::Encoding ContentDecoder::parseEncoding(const std::string& content_encoding) {
+    std::string value = content_encoding;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (value.empty() || value == "identity") {
+        return Encoding::Identity;
+    }
+    if (value == "gzip" || value == "x-gzip") {
+        return isCompressionSupported() ? Encoding::Gzip : Encoding::Unsupported;
+    }
+    if (value == "deflate") {
+        return isCompressionSupported() ? Encoding::Deflate : Encoding::Unsupported;
+    }
+    return Encoding::Unsupported;
+}
+
+bool ContentDecoder::isCompressionSupported() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* ContentDecoder::acceptEncoding() {
+    return isCompressionSupported() ? "gzip, deflate" : "identity";
+}
+
+const char* ContentDecoder::encodingName() const {
+    switch (encoding_) {
+        case Encoding::Identity: return "identity";
+        case Encoding::Gzip: return "gzip";
+        case Encoding::Deflate: return "deflate";
+        default: return "unsupported";
+    }
+}
+
+bool ContentDecoder::decode(const char* data, size_t length, const Sink& sink) {
+    if (encoding_ == Encoding::Identity) {
+        return sink(data, length);
+    }
+
+#ifdef HAVE_ZLIB
+    if (!zlib_ || !zlib_->initialized) {
+        return false;
+    }
+    if (zlib_->finished) {
+        // Trailing bytes after the end of the compressed stream are ignored
+        return true;
+    }
+
+    char out[DECODE_CHUNK_SIZE];
+    auto& stream = zlib_->stream;
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(length);
+
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(out);
+        stream.avail_out = sizeof(out);
+
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            return false;
+        }
+
+        size_t produced = sizeof(out) - stream.avail_out;
+        if (produced > 0 && !sink(out, produced)) {
+            return false;
+        }
+
+        if (ret == Z_STREAM_END) {
+            zlib_->finished = true;
+            break;
+        }
+        if (ret == Z_BUF_ERROR && produced == 0) {
+            // Needs more input
+            break;
+        }
+    } while (stream.avail_in > 0 || stream.avail_out == 0);
+
+    return true;
+#else
+    (void)data;
+    (void)length;
+    return false;
+#endif
+}
@@ -0,0 +1,56 @@
+#ifndef CONTENT_DECODER_H
+#define CONTENT_DECODER_H
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+/**
+ * Streaming decoder for HTTP Content-Encoding (gzip/deflate).
+ * Wire bytes are fed in as they arrive from the socket and decoded bytes
+ * are handed to a sink in bounded chunks, so a compressed response never
+ * has to be held in memory twice. Requires zlib (HAVE_ZLIB); without it
+ * only the identity encoding is available.
+ */
+class ContentDecoder {
+public:
+    enum class Encoding {
+        Identity,
+        Gzip,
+        Deflate,
+        Unsupported
+    };
+
+    // Receives decoded bytes; returning false aborts decoding
+    using Sink = std::function<bool(const char* data, size_t length)>;
+
+    explicit ContentDecoder(Encoding encoding);
+    ~ContentDecoder();
+    ContentDecoder(const ContentDecoder&) = delete;
+    ContentDecoder& operator=(const ContentDecoder&) = delete;
+
+    // Map a Content-Encoding header value to an encoding
+    static Encoding parseEncoding(const std::string& content_encoding);
+
+    // True if this build can decode compressed responses
+    static bool isCompressionSupported();
+
+    // Accept-Encoding value advertising what this build can decode
+    static const char* acceptEncoding();
+
+    // Decode one chunk of wire bytes. Returns false on a corrupt stream or
+    // if the sink asked to stop.
+    bool decode(const char* data, size_t length, const Sink& sink);
+
+    Encoding encoding() const { return encoding_; }
+    const char* encodingName() const;
+
+private:
+    struct ZlibState;
+
+    Encoding encoding_;
+    std::unique_ptr<ZlibState> zlib_;
+};
+
+#endif // CONTENT_DECODER_H
@@ -0,0 +1,36 @@
+#ifndef DETACHED_TASK_H
+#define DETACHED_TASK_H
+
+#include <future>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <exception>
+
+// Run fn on a detached thread and return a future for its result. Unlike
+// std::async, abandoning the future after a timeout does not block.
+template <typename Fn>
+auto runDetached(Fn fn) -> std::future<decltype(fn())> {
+    using Result = decltype(fn());
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+    std::thread([promise, fn = std::move(fn)]() mutable {
+        try {
+            promise->set_value(fn());
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    }).detach();
+    return future;
+}
+
+// Wait for a result until the deadline; a default (invalid) value on timeout
+template <typename T>
+T waitUntil(std::future<T>& future, std::chrono::steady_clock::time_point deadline) {
+    if (future.wait_until(deadline) != std::future_status::ready) {
+        return T();
+    }
+    return future.get();
+}
+
+#endif // DETACHED_TASK_H
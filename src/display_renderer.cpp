@@ -1,6 +1,7 @@
 #include "display_renderer.h"
 #include "sdl_emulator.h"
 #include "weather_icons_large.h"
+#include "text_layout.h"
 
 // Include generated font headers
 #include "../fonts/inter24.h"
@@ -17,9 +18,48 @@ extern "C" {
 
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+// A font for draw_text_centered and the box height it needs
+template <typename FontT, int MinHeight>
+struct TextFont {
+    using Font = FontT;
+    static constexpr int min_height = MinHeight;
+};
+
+// Largest first; the last entry is used for any remaining height
+using TextFonts = std::tuple<
+    TextFont<font_Inter_Regular_48::Font, 60>,
+    TextFont<font_Inter_Regular_32::Font, 40>,
+    TextFont<font_Inter_Regular_24::Font, 0>
+>;
+
+// Call fn(TextFont<...>{}) with the largest font that fits height
+template <size_t I = 0, typename Fn>
+void with_text_font(int height, Fn&& fn) {
+    using Entry = std::tuple_element_t<I, TextFonts>;
+    if constexpr (I + 1 == std::tuple_size_v<TextFonts>) {
+        fn(Entry{});
+    } else {
+        if (height >= Entry::min_height) {
+            fn(Entry{});
+        } else {
+            with_text_font<I + 1>(height, std::forward<Fn>(fn));
+        }
+    }
+}
+
+} // namespace
 
 DisplayRenderer::DisplayRenderer()
-    : backbuffer_(SCREEN_WIDTH * SCREEN_HEIGHT, WHITE)
+    : backbuffer_(PACKED_SIZE, (WHITE << 4) | WHITE)
+    , presented_(PACKED_SIZE, (WHITE << 4) | WHITE)
+    , has_presented_(false)
+    , clip_{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}
     , sdl_emulator_(nullptr)
     , inky_display_(nullptr)
     , use_sdl_(false)
@@ -76,28 +116,79 @@ void DisplayRenderer::shutdown() {
 }
 
 void DisplayRenderer::clear(uint8_t color) {
-    std::fill(backbuffer_.begin(), backbuffer_.end(), color);
+    color &= 0x0F;
+    std::fill(backbuffer_.begin(), backbuffer_.end(), static_cast<uint8_t>((color << 4) | color));
 }
 
 void DisplayRenderer::set_pixel(int x, int y, uint8_t color) {
-    if (is_valid_pixel(x, y)) {
-        backbuffer_[y * SCREEN_WIDTH + x] = color;
+    if (in_clip(x, y)) {
+        put_pixel(x, y, color);
     }
 }
 
 uint8_t DisplayRenderer::get_pixel(int x, int y) const {
     if (is_valid_pixel(x, y)) {
-        return backbuffer_[y * SCREEN_WIDTH + x];
+        return packed_pixel(backbuffer_.data(), x, y);
     }
     return WHITE;  // Default to white for out-of-bounds
 }
 
+void DisplayRenderer::push_clip(int x, int y, int w, int h) {
+    clip_stack_.push_back(clip_);
+    if (!clip(x, y, w, h)) {
+        w = 0;
+        h = 0;
+    }
+    clip_ = {x, y, w, h};
+}
+
+void DisplayRenderer::pop_clip() {
+    if (clip_stack_.empty()) {
+        return;
+    }
+    clip_ = clip_stack_.back();
+    clip_stack_.pop_back();
+}
+
+void DisplayRenderer::draw_hline(int x, int y, int w, uint8_t color) {
+    draw_rectangle(x, y, w, 1, color);
+}
+
+void DisplayRenderer::draw_vline(int x, int y, int h, uint8_t color) {
+    draw_rectangle(x, y, 1, h, color);
+}
+
 void DisplayRenderer::draw_rectangle(int x, int y, int w, int h, uint8_t color) {
-    for (int dy = 0; dy < h; dy++) {
-        for (int dx = 0; dx < w; dx++) {
-            set_pixel(x + dx, y + dy, color);
+    if (!clip(x, y, w, h)) {
+        return;
+    }
+    if (w == 1) {
+        // Single column: the same nibble of each row's byte
+        uint8_t keep = (x & 1) ? 0xF0 : 0x0F;
+        uint8_t value = (x & 1) ? (color & 0x0F) : static_cast<uint8_t>(color << 4);
+        uint8_t* pair = backbuffer_.data() + y * PACKED_STRIDE + x / 2;
+        for (int row = 0; row < h; row++, pair += PACKED_STRIDE) {
+            *pair = (*pair & keep) | value;
         }
+        return;
     }
+    for (int row = y; row < y + h; row++) {
+        fill_span(x, row, w, color);
+    }
+}
+
+void DisplayRenderer::draw_rect_outline(int x, int y, int w, int h, int thickness, uint8_t color) {
+    if (w <= 0 || h <= 0 || thickness <= 0) {
+        return;
+    }
+    if (thickness * 2 >= w || thickness * 2 >= h) {
+        draw_rectangle(x, y, w, h, color);
+        return;
+    }
+    draw_rectangle(x, y, w, thickness, color);                                  // Top
+    draw_rectangle(x, y + h - thickness, w, thickness, color);                  // Bottom
+    draw_rectangle(x, y + thickness, thickness, h - thickness * 2, color);      // Left
+    draw_rectangle(x + w - thickness, y + thickness, thickness, h - thickness * 2, color);  // Right
 }
 
 void DisplayRenderer::draw_weather_icon(int x, int y, int w, int h, const std::string& icon_name) {
@@ -118,279 +209,110 @@ void DisplayRenderer::draw_weather_icon(int x, int y, int w, int h, const std::s
     int icon_x = x + (w - icon->width) / 2;
     int icon_y = y + (h - icon->height) / 2;
     
-    // Draw the icon to backbuffer
-    for (int iy = 0; iy < icon->height; iy++) {
-        for (int ix = 0; ix < icon->width; ix++) {
-            int px = icon_x + ix;
-            int py = icon_y + iy;
-            
-            if (is_valid_pixel(px, py)) {
-                uint8_t pixel = icon->data[iy * icon->width + ix];
-                
-                // Skip white pixels (background/transparent)
-                if (pixel != WHITE) {
-                    set_pixel(px, py, pixel);
-                }
+    // Clip once, then copy each row as runs of one colour
+    int cx = icon_x, cy = icon_y, cw = icon->width, ch = icon->height;
+    if (!clip(cx, cy, cw, ch)) {
+        return;
+    }
+    for (int py = cy; py < cy + ch; py++) {
+        const uint8_t* src = icon->data + (py - icon_y) * icon->width + (cx - icon_x);
+        int ix = 0;
+        while (ix < cw) {
+            uint8_t pixel = src[ix];
+            int run = 1;
+            while (ix + run < cw && src[ix + run] == pixel) {
+                run++;
+            }
+            // Skip white pixels (background/transparent)
+            if (pixel != WHITE) {
+                fill_span(cx + ix, py, run, pixel);
             }
+            ix += run;
         }
     }
 }
 
 void DisplayRenderer::draw_text_centered(int x, int y, int w, int h, const std::string& text, uint8_t color) {
     // Choose font based on available height
-    const uint8_t* font_atlas = nullptr;
-    const font_Inter_Regular_24::CharData* char_data_24 = nullptr;
-    const font_Inter_Regular_32::CharData* char_data_32 = nullptr;
-    const font_Inter_Regular_48::CharData* char_data_48 = nullptr;
-    int atlas_width = 0, atlas_height = 0;
-    int char_count = 0, line_height = 0, baseline = 0;
-    int font_size = 24;
-    
-    if (h >= 60) {
-        // Use 48pt font
-        font_atlas = font_Inter_Regular_48::atlas_data;
-        char_data_48 = font_Inter_Regular_48::char_data;
-        atlas_width = font_Inter_Regular_48::atlas_width;
-        atlas_height = font_Inter_Regular_48::atlas_height;
-        char_count = font_Inter_Regular_48::char_count;
-        line_height = font_Inter_Regular_48::line_height;
-        baseline = font_Inter_Regular_48::baseline;
-        font_size = 48;
-    } else if (h >= 40) {
-        // Use 32pt font
-        font_atlas = font_Inter_Regular_32::atlas_data;
-        char_data_32 = font_Inter_Regular_32::char_data;
-        atlas_width = font_Inter_Regular_32::atlas_width;
-        atlas_height = font_Inter_Regular_32::atlas_height;
-        char_count = font_Inter_Regular_32::char_count;
-        line_height = font_Inter_Regular_32::line_height;
-        baseline = font_Inter_Regular_32::baseline;
-        font_size = 32;
-    } else {
-        // Use 24pt font
-        font_atlas = font_Inter_Regular_24::atlas_data;
-        char_data_24 = font_Inter_Regular_24::char_data;
-        atlas_width = font_Inter_Regular_24::atlas_width;
-        atlas_height = font_Inter_Regular_24::atlas_height;
-        char_count = font_Inter_Regular_24::char_count;
-        line_height = font_Inter_Regular_24::line_height;
-        baseline = font_Inter_Regular_24::baseline;
-        font_size = 24;
-    }
-    
-    // Calculate text width for centering with UTF-8 decoding
+    with_text_font(h, [&](auto entry) {
+        using Font = typename decltype(entry)::Font;
+        draw_text_with<Font>(x, y, w, h, text, color);
+    });
+}
+
+template <typename Font>
+void DisplayRenderer::draw_text_with(int x, int y, int w, int h, const std::string& text, uint8_t color) {
+    // Resolve every character once, measuring the text width for centering
+    std::vector<const typename Font::Glyph*> glyphs;
+    glyphs.reserve(text.size());
     int text_width = 0;
-    for (size_t i = 0; i < text.size();) {
-        uint32_t codepoint;
-        
-        // Simple UTF-8 decoding for common characters
-        unsigned char byte1 = static_cast<unsigned char>(text[i]);
-        if (byte1 < 0x80) {
-            // ASCII character (0xxxxxxx)
-            codepoint = byte1;
-            i++;
-        } else if ((byte1 & 0xE0) == 0xC0 && i + 1 < text.size()) {
-            // 2-byte UTF-8 character (110xxxxx 10xxxxxx)
-            unsigned char byte2 = static_cast<unsigned char>(text[i + 1]);
-            if ((byte2 & 0xC0) == 0x80) {
-                codepoint = ((byte1 & 0x1F) << 6) | (byte2 & 0x3F);
-                i += 2;
-            } else {
-                // Invalid UTF-8, skip this byte
-                i++;
-                continue;
-            }
-        } else {
-            // Unsupported UTF-8 sequence or invalid, skip this byte
-            i++;
-            continue;
-        }
-        
-        // Find character in font data
-        bool found = false;
-        int advance = 0;
-        
-        if (font_size == 48 && char_data_48) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_48[i].codepoint == codepoint) {
-                    advance = char_data_48[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        } else if (font_size == 32 && char_data_32) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_32[i].codepoint == codepoint) {
-                    advance = char_data_32[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        } else if (font_size == 24 && char_data_24) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_24[i].codepoint == codepoint) {
-                    advance = char_data_24[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        }
-        
-        if (found) {
-            text_width += advance;
-        } else {
-            // Default character width
-            text_width += font_size / 2;
-        }
-    }
+    for_each_glyph<Font>(text, [&](const typename Font::Glyph* glyph) {
+        // Without even a fallback glyph, leave a gap
+        text_width += glyph ? glyph->advance : Font::size / 2;
+        glyphs.push_back(glyph);
+    });
     
     // Center the text vertically in the available space
     int start_x = x + (w - text_width) / 2;
     // Center based on actual font height, accounting for ascent/descent
     // Move the baseline up by approximately half the font size for better visual centering
-    int start_y = y + h / 2 - font_size / 4;
+    int start_y = y + h / 2 - Font::size / 4;
     
+    // Render each glyph to backbuffer, clipped once and written as runs
     int cur_x = start_x;
-    
-    // Render each character to backbuffer with UTF-8 decoding
-    for (size_t i = 0; i < text.size();) {
-        uint32_t codepoint;
-        
-        // Simple UTF-8 decoding for common characters
-        unsigned char byte1 = static_cast<unsigned char>(text[i]);
-        if (byte1 < 0x80) {
-            // ASCII character (0xxxxxxx)
-            codepoint = byte1;
-            i++;
-        } else if ((byte1 & 0xE0) == 0xC0 && i + 1 < text.size()) {
-            // 2-byte UTF-8 character (110xxxxx 10xxxxxx)
-            unsigned char byte2 = static_cast<unsigned char>(text[i + 1]);
-            if ((byte2 & 0xC0) == 0x80) {
-                codepoint = ((byte1 & 0x1F) << 6) | (byte2 & 0x3F);
-                i += 2;
-            } else {
-                // Invalid UTF-8, skip this byte
-                i++;
-                continue;
-            }
-        } else {
-            // Unsupported UTF-8 sequence or invalid, skip this byte
-            i++;
+    for (const auto* glyph : glyphs) {
+        if (!glyph) {
+            cur_x += Font::size / 2;
             continue;
         }
-        
-        // Find character in font data
-        bool found = false;
-        int char_x = 0, char_y = 0, char_w = 0, char_h = 0;
-        int xoff = 0, yoff = 0, advance = 0;
-        
-        if (font_size == 48 && char_data_48) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_48[i].codepoint == codepoint) {
-                    char_x = char_data_48[i].x;
-                    char_y = char_data_48[i].y;
-                    char_w = char_data_48[i].w;
-                    char_h = char_data_48[i].h;
-                    xoff = char_data_48[i].xoff;
-                    yoff = char_data_48[i].yoff;
-                    advance = char_data_48[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        } else if (font_size == 32 && char_data_32) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_32[i].codepoint == codepoint) {
-                    char_x = char_data_32[i].x;
-                    char_y = char_data_32[i].y;
-                    char_w = char_data_32[i].w;
-                    char_h = char_data_32[i].h;
-                    xoff = char_data_32[i].xoff;
-                    yoff = char_data_32[i].yoff;
-                    advance = char_data_32[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        } else if (font_size == 24 && char_data_24) {
-            for (int i = 0; i < char_count; i++) {
-                if (char_data_24[i].codepoint == codepoint) {
-                    char_x = char_data_24[i].x;
-                    char_y = char_data_24[i].y;
-                    char_w = char_data_24[i].w;
-                    char_h = char_data_24[i].h;
-                    xoff = char_data_24[i].xoff;
-                    yoff = char_data_24[i].yoff;
-                    advance = char_data_24[i].advance;
-                    found = true;
-                    break;
-                }
-            }
-        }
-        
-        if (found && char_w > 0 && char_h > 0) {
-            // Render the glyph from the atlas to backbuffer
-            for (int gy = 0; gy < char_h; gy++) {
-                for (int gx = 0; gx < char_w; gx++) {
-                    int atlas_idx = (char_y + gy) * atlas_width + (char_x + gx);
-                    uint8_t alpha = font_atlas[atlas_idx];
-                    
-                    // Only draw visible pixels (threshold alpha)
-                    if (alpha > 128) {
-                        int px = cur_x + xoff + gx;
-                        int py = start_y + yoff + gy;
-                        
-                        if (is_valid_pixel(px, py)) {
-                            set_pixel(px, py, color);
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Move to next character position
-        if (found) {
-            cur_x += advance;
-        } else {
-            // Default advance for unknown characters
-            cur_x += font_size / 2;
-        }
+        blit_glyph<Font>(*glyph, cur_x, start_y,
+            [this](int& cx, int& cy, int& cw, int& ch) { return clip(cx, cy, cw, ch); },
+            [this, color](int sx, int sy, int length) { fill_span(sx, sy, length, color); });
+        cur_x += glyph->advance;
     }
 }
 
 void DisplayRenderer::draw_panel_border(int panel_x, int panel_y, int panel_w, int panel_h) {
     constexpr int BORDER_WIDTH = 3;
     
-    // Simple border drawing to backbuffer
+    // Rings growing outwards; each spans [panel - i, panel + size + i)
     for (int i = 0; i < BORDER_WIDTH; i++) {
-        // Top and bottom borders
-        for (int x = panel_x - i; x < panel_x + panel_w + i; x++) {
-            if (x >= 0 && x < SCREEN_WIDTH) {
-                if (panel_y - i >= 0) {
-                    set_pixel(x, panel_y - i, BLACK);
-                }
-                if (panel_y + panel_h + i < SCREEN_HEIGHT) {
-                    set_pixel(x, panel_y + panel_h + i, BLACK);
-                }
-            }
-        }
-        // Left and right borders
-        for (int y = panel_y - i; y < panel_y + panel_h + i; y++) {
-            if (y >= 0 && y < SCREEN_HEIGHT) {
-                if (panel_x - i >= 0) {
-                    set_pixel(panel_x - i, y, BLACK);
-                }
-                if (panel_x + panel_w + i < SCREEN_WIDTH) {
-                    set_pixel(panel_x + panel_w + i, y, BLACK);
-                }
-            }
-        }
+        int length_x = panel_w + i * 2;
+        int length_y = panel_h + i * 2;
+        draw_hline(panel_x - i, panel_y - i, length_x, BLACK);            // Top
+        draw_hline(panel_x - i, panel_y + panel_h + i, length_x, BLACK);  // Bottom
+        draw_vline(panel_x - i, panel_y - i, length_y, BLACK);            // Left
+        draw_vline(panel_x + panel_w + i, panel_y - i, length_y, BLACK);  // Right
     }
 }
 
-void DisplayRenderer::present() {
+bool DisplayRenderer::present() {
     if (!initialized_) {
-        return;
+        return false;
+    }
+    
+    present_stats_.frames++;
+    compute_frame_diff(last_diff_);
+    
+    // An e-ink refresh takes ~30 seconds; never repeat one for the same frame
+    if (last_diff_.unchanged()) {
+        present_stats_.skipped++;
+        std::cout << "Display unchanged, skipping refresh (" << present_stats_.skipped
+                  << " of " << present_stats_.frames << " frames skipped)" << std::endl;
+        return false;
+    }
+    
+    if (last_diff_.full_frame) {
+        std::cout << "Display: presenting first frame" << std::endl;
+    } else {
+        std::cout << "Display: " << last_diff_.changed_pixels << " pixels changed in "
+                  << last_diff_.regions.size() << " region(s)" << std::endl;
+        if (debug_enabled_) {
+            for (const auto& rect : last_diff_.regions) {
+                std::cout << "  dirty " << rect.x << "," << rect.y << " "
+                          << rect.w << "x" << rect.h << std::endl;
+            }
+        }
     }
     
     // Update SDL display
@@ -400,8 +322,13 @@ void DisplayRenderer::present() {
     
     // Update Inky display
     if (use_inky_ && inky_display_) {
-        update_inky_display();
+        update_inky_display(last_diff_);
     }
+    
+    presented_ = backbuffer_;
+    has_presented_ = true;
+    present_stats_.refreshes++;
+    return true;
 }
 
 bool DisplayRenderer::save_png(const std::string& filename) {
@@ -422,7 +349,7 @@ bool DisplayRenderer::save_png(const std::string& filename) {
     };
     
     for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
-        uint8_t color = backbuffer_[i];
+        uint8_t color = packed_pixel(backbuffer_.data(), i % SCREEN_WIDTH, i / SCREEN_WIDTH);
         if (color < 8) {
             rgb_buffer[i * 3] = inky_palette[color].r;
             rgb_buffer[i * 3 + 1] = inky_palette[color].g;
@@ -456,23 +383,134 @@ bool DisplayRenderer::is_valid_pixel(int x, int y) const {
     return x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT;
 }
 
+uint8_t DisplayRenderer::packed_pixel(const uint8_t* buffer, int x, int y) {
+    uint8_t pair = buffer[y * PACKED_STRIDE + x / 2];
+    return (x & 1) ? (pair & 0x0F) : (pair >> 4);
+}
+
+bool DisplayRenderer::clip(int& x, int& y, int& w, int& h) const {
+    int x0 = std::max(x, clip_.x);
+    int y0 = std::max(y, clip_.y);
+    int x1 = std::min(x + w, clip_.x + clip_.w);
+    int y1 = std::min(y + h, clip_.y + clip_.h);
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    x = x0;
+    y = y0;
+    w = x1 - x0;
+    h = y1 - y0;
+    return true;
+}
+
+bool DisplayRenderer::in_clip(int x, int y) const {
+    return x >= clip_.x && x < clip_.x + clip_.w && y >= clip_.y && y < clip_.y + clip_.h;
+}
+
+void DisplayRenderer::put_pixel(int x, int y, uint8_t color) {
+    uint8_t& pair = backbuffer_[y * PACKED_STRIDE + x / 2];
+    if (x & 1) {
+        pair = (pair & 0xF0) | (color & 0x0F);
+    } else {
+        pair = (pair & 0x0F) | static_cast<uint8_t>(color << 4);
+    }
+}
+
+void DisplayRenderer::fill_span(int x, int y, int w, uint8_t color) {
+    uint8_t* row = backbuffer_.data() + y * PACKED_STRIDE;
+    int end = x + w;
+    
+    // Odd leading pixel shares its byte with the left neighbour
+    if ((x & 1) && x < end) {
+        put_pixel(x, y, color);
+        x++;
+    }
+    int pairs = (end - x) / 2;
+    if (pairs > 0) {
+        color &= 0x0F;
+        std::memset(row + x / 2, (color << 4) | color, pairs);
+        x += pairs * 2;
+    }
+    if (x < end) {
+        put_pixel(x, y, color);
+    }
+}
+
+void DisplayRenderer::compute_frame_diff(FrameDiff& diff) const {
+    diff.full_frame = !has_presented_;
+    diff.changed_pixels = 0;
+    diff.regions.clear();
+    
+    if (diff.full_frame) {
+        diff.changed_pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
+        diff.regions.push_back({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+        return;
+    }
+    
+    // Consecutive changed rows form one region spanning their changed columns
+    bool in_region = false;
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        const uint8_t* row = backbuffer_.data() + y * PACKED_STRIDE;
+        const uint8_t* shown = presented_.data() + y * PACKED_STRIDE;
+        if (std::memcmp(row, shown, PACKED_STRIDE) == 0) {
+            in_region = false;
+            continue;
+        }
+        
+        // Compare a byte (pixel pair) at a time, then its nibbles
+        int min_x = SCREEN_WIDTH;
+        int max_x = -1;
+        for (int i = 0; i < PACKED_STRIDE; i++) {
+            uint8_t changed = row[i] ^ shown[i];
+            if (!changed) {
+                continue;
+            }
+            if (changed & 0xF0) {
+                min_x = std::min(min_x, i * 2);
+                max_x = i * 2;
+                diff.changed_pixels++;
+            }
+            if (changed & 0x0F) {
+                min_x = std::min(min_x, i * 2 + 1);
+                max_x = i * 2 + 1;
+                diff.changed_pixels++;
+            }
+        }
+        
+        if (!in_region) {
+            diff.regions.push_back({min_x, y, max_x - min_x + 1, 1});
+            in_region = true;
+        } else {
+            Rect& rect = diff.regions.back();
+            int right = std::max(rect.x + rect.w, max_x + 1);
+            rect.x = std::min(rect.x, min_x);
+            rect.w = right - rect.x;
+            rect.h = y - rect.y + 1;
+        }
+    }
+}
+
 void DisplayRenderer::update_sdl_display() {
     // Copy backbuffer to SDL emulator
     for (int y = 0; y < SCREEN_HEIGHT; y++) {
         for (int x = 0; x < SCREEN_WIDTH; x++) {
-            uint8_t color = backbuffer_[y * SCREEN_WIDTH + x];
+            uint8_t color = packed_pixel(backbuffer_.data(), x, y);
             sdl_emulator_->set_pixel(x, y, color);
         }
     }
     sdl_emulator_->update();
 }
 
-void DisplayRenderer::update_inky_display() {
-    // Copy backbuffer to Inky display
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            uint8_t color = backbuffer_[y * SCREEN_WIDTH + x];
-            inky_set_pixel(inky_display_, x, y, color);
+void DisplayRenderer::update_inky_display(const FrameDiff& diff) {
+    // The Inky buffer still holds the last frame; copy only what changed.
+    // inky_c only takes single pixels; handing over packed_pixels() in one
+    // call needs a buffer-level entry point added to the library first.
+    for (const auto& rect : diff.regions) {
+        for (int y = rect.y; y < rect.y + rect.h; y++) {
+            for (int x = rect.x; x < rect.x + rect.w; x++) {
+                uint8_t color = packed_pixel(backbuffer_.data(), x, y);
+                inky_set_pixel(inky_display_, x, y, color);
+            }
         }
     }
     
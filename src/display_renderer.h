@@ -9,6 +9,26 @@
 class SDL3Emulator;
 typedef struct inky_display inky_t;
 
+// Screen rectangle: clip areas and changed regions
+struct Rect {
+    int x, y, w, h;
+};
+
+// Result of comparing the backbuffer with what is on the display
+struct FrameDiff {
+    bool full_frame = false;        // Nothing presented yet; the whole screen is new
+    int changed_pixels = 0;
+    std::vector<Rect> regions;      // Bounding box of each run of changed rows
+    
+    bool unchanged() const { return !full_frame && changed_pixels == 0; }
+};
+
+struct PresentStats {
+    uint64_t frames = 0;       // present() calls
+    uint64_t refreshes = 0;    // Frames pushed to the targets
+    uint64_t skipped = 0;      // Frames identical to the one already shown
+};
+
 /**
  * Unified display renderer that renders to a common backbuffer
  * and outputs to different target devices (SDL, Inky hardware, PNG files)
@@ -19,6 +39,12 @@ public:
     static constexpr int SCREEN_WIDTH = 600;
     static constexpr int SCREEN_HEIGHT = 448;
     
+    // Packed backbuffer layout: 4 bits per pixel, two pixels per byte with
+    // the left pixel in the high nibble, as the panel receives them
+    static constexpr int PACKED_STRIDE = SCREEN_WIDTH / 2;
+    static constexpr size_t PACKED_SIZE = static_cast<size_t>(PACKED_STRIDE) * SCREEN_HEIGHT;
+    static_assert(SCREEN_WIDTH % 2 == 0, "rows must pack into whole bytes");
+    
     // Inky 7-color palette
     static constexpr uint8_t BLACK = 0;
     static constexpr uint8_t WHITE = 1;
@@ -36,19 +62,38 @@ public:
     bool initialize(bool use_sdl_emulator = true, inky_t* inky_display = nullptr, bool debug = false);
     void shutdown();
     
-    // Common backbuffer operations
+    // Common backbuffer operations; clear() ignores the clip rect
     void clear(uint8_t color = WHITE);
     void set_pixel(int x, int y, uint8_t color);
     uint8_t get_pixel(int x, int y) const;
     
+    // The whole frame in the panel's packed format, for a bulk transfer
+    const uint8_t* packed_pixels() const { return backbuffer_.data(); }
+    size_t packed_size() const { return backbuffer_.size(); }
+    
+    // Clip stack: drawing is limited to the intersection of every pushed
+    // rect and the screen
+    void push_clip(int x, int y, int w, int h);
+    void pop_clip();
+    const Rect& clip_rect() const { return clip_; }
+    
+    // Primitives, clipped once and written as row spans
+    void draw_hline(int x, int y, int w, uint8_t color);
+    void draw_vline(int x, int y, int h, uint8_t color);
+    void draw_rectangle(int x, int y, int w, int h, uint8_t color);  // Filled
+    void draw_rect_outline(int x, int y, int w, int h, int thickness, uint8_t color);
+    
     // High-level drawing operations
-    void draw_rectangle(int x, int y, int w, int h, uint8_t color);
     void draw_weather_icon(int x, int y, int w, int h, const std::string& icon_name);
     void draw_text_centered(int x, int y, int w, int h, const std::string& text, uint8_t color);
     void draw_panel_border(int panel_x, int panel_y, int panel_w, int panel_h);
     
     // Output to target devices
-    void present();  // Update SDL and/or Inky display
+    // Update SDL and/or Inky display; a frame identical to the last one
+    // presented is skipped. Returns true if the targets were updated.
+    bool present();
+    const FrameDiff& last_frame_diff() const { return last_diff_; }
+    PresentStats get_present_stats() const { return present_stats_; }
     bool save_png(const std::string& filename);  // Save backbuffer to PNG
     
     // Event handling for SDL
@@ -56,9 +101,20 @@ public:
     bool should_quit() const;
     
 private:
-    // Backbuffer storage (one byte per pixel, Inky palette values)
+    // Backbuffer storage (packed 4bpp Inky palette values, PACKED_SIZE bytes)
     std::vector<uint8_t> backbuffer_;
     
+    // Copy of the frame last sent to the targets, for diffing (same layout).
+    // With it the two packed buffers total what one unpacked buffer took.
+    std::vector<uint8_t> presented_;
+    bool has_presented_;
+    FrameDiff last_diff_;
+    PresentStats present_stats_;
+    
+    // Current clip rect, and the ones saved by push_clip
+    Rect clip_;
+    std::vector<Rect> clip_stack_;
+    
     // Target devices
     std::unique_ptr<SDL3Emulator> sdl_emulator_;
     inky_t* inky_display_;
@@ -69,6 +125,17 @@ private:
     
     // Helper methods
     bool is_valid_pixel(int x, int y) const;
+    static uint8_t packed_pixel(const uint8_t* buffer, int x, int y);
+    // Intersect with the clip rect; false if nothing is left to draw
+    bool clip(int& x, int& y, int& w, int& h) const;
+    bool in_clip(int x, int y) const;
+    // Unchecked writes; callers have already clipped
+    void put_pixel(int x, int y, uint8_t color);
+    void fill_span(int x, int y, int w, uint8_t color);
+    void compute_frame_diff(FrameDiff& diff) const;
+    // draw_text_centered in one font (a generated Font descriptor)
+    template <typename Font>
+    void draw_text_with(int x, int y, int w, int h, const std::string& text, uint8_t color);
     void update_sdl_display();
-    void update_inky_display();
+    void update_inky_display(const FrameDiff& diff);
 };
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "endpoint_cache.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Read the whole file; an empty object if missing, unreadable or from
+// another format version
+json readFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return json::object();
+    }
+
+    try {
+        json root;
+        file >> root;
+        if (!root.is_object() || root.value("version", 0) != EndpointCache::FORMAT_VERSION) {
+            std::cout << "Ignoring endpoint cache " << path << " (format version mismatch)" << std::endl;
+            return json::object();
+        }
+        return root;
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring unreadable endpoint cache " << path << ": " << e.what() << std::endl;
+        return json::object();
+    }
+}
+
+} // namespace
+
+EndpointCache::EndpointCache(const std::string& path)
+    : path_(path)
+{
+}
+
+std::string EndpointCache::locationKey(double latitude, double longitude) {
+    std::stringstream key;
+    key << std::fixed << std::setprecision(4) << latitude << "," << longitude;
+    return key.str();
+}
+
+std::optional<ResolvedEndpoints> EndpointCache::load(double latitude, double longitude) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    json root = readFile(path_);
+    if (!root.contains("locations")) {
+        return std::nullopt;
+    }
+
+    auto it = root["locations"].find(locationKey(latitude, longitude));
+    if (it == root["locations"].end()) {
+        return std::nullopt;
+    }
+
+    try {
+        const json& entry = *it;
+        ResolvedEndpoints endpoints;
+        endpoints.latitude = latitude;
+        endpoints.longitude = longitude;
+        endpoints.resolved_at = entry.at("resolved_at").get<std::time_t>();
+
+        NWSPoints& points = endpoints.points;
+        points.forecast_grid_url = entry.at("forecast_grid_url").get<std::string>();
+        points.stations_url = entry.at("stations_url").get<std::string>();
+        points.forecast_url = entry.at("forecast_url").get<std::string>();
+        points.forecast_hourly_url = entry.value("forecast_hourly_url", "");
+        points.office_id = entry.at("office_id").get<std::string>();
+        points.grid_x = entry.at("grid_x").get<int>();
+        points.grid_y = entry.at("grid_y").get<int>();
+        points.valid = true;
+
+        for (const auto& item : entry.at("stations")) {
+            NWSStation station;
+            station.id = item.at("id").get<std::string>();
+            station.name = item.value("name", "");
+            station.latitude = item.at("latitude").get<double>();
+            station.longitude = item.at("longitude").get<double>();
+            station.distance_km = item.value("distance_km", 0.0);
+            endpoints.stations.push_back(station);
+        }
+
+        if (!endpoints.isValid()) {
+            return std::nullopt;
+        }
+        return endpoints;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring malformed endpoint cache entry: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+bool EndpointCache::store(const ResolvedEndpoints& endpoints) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    try {
+        json root = readFile(path_);
+        root["version"] = FORMAT_VERSION;
+        if (!root.contains("locations") || !root["locations"].is_object()) {
+            root["locations"] = json::object();
+        }
+
+        const NWSPoints& points = endpoints.points;
+        json entry;
+        entry["resolved_at"] = endpoints.resolved_at;
+        entry["forecast_grid_url"] = points.forecast_grid_url;
+        entry["stations_url"] = points.stations_url;
+        entry["forecast_url"] = points.forecast_url;
+        entry["forecast_hourly_url"] = points.forecast_hourly_url;
+        entry["office_id"] = points.office_id;
+        entry["grid_x"] = points.grid_x;
+        entry["grid_y"] = points.grid_y;
+
+        entry["stations"] = json::array();
+        for (const auto& station : endpoints.stations) {
+            entry["stations"].push_back({
+                {"id", station.id},
+                {"name", station.name},
+                {"latitude", station.latitude},
+                {"longitude", station.longitude},
+                {"distance_km", station.distance_km}
+            });
+        }
+
+        root["locations"][locationKey(endpoints.latitude, endpoints.longitude)] = entry;
+
+        std::string tmp_path = path_ + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Could not write endpoint cache: " << tmp_path << std::endl;
+                return false;
+            }
+            file << root.dump(2) << std::endl;
+            if (!file.good()) {
+                std::cerr << "Could not write endpoint cache: " << tmp_path << std::endl;
+                return false;
+            }
+        }
+
+        if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+            std::cerr << "Could not replace endpoint cache: " << path_ << std::endl;
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving endpoint cache: " << e.what() << std::endl;
+        return false;
+    }
+}
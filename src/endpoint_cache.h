@@ -0,0 +1,54 @@
+#ifndef ENDPOINT_CACHE_H
+#define ENDPOINT_CACHE_H
+
+#include "nws_client.h"
+#include <string>
+#include <vector>
+#include <optional>
+#include <mutex>
+#include <ctime>
+
+// Everything the /points and stations lookups resolve for one location
+struct ResolvedEndpoints {
+    double latitude = 0.0;
+    double longitude = 0.0;
+    NWSPoints points;                   // Endpoint URLs and grid office/X/Y
+    std::vector<NWSStation> stations;   // Nearest first
+    std::time_t resolved_at = 0;        // Wall-clock time of the lookup
+
+    bool isValid() const { return points.valid && !stations.empty(); }
+};
+
+// Delay before retrying a failed revalidation
+constexpr std::time_t ENDPOINT_RETRY_SECONDS = 60 * 60;
+
+/**
+ * On-disk cache of resolved NWS endpoints, keyed by latitude/longitude.
+ * Lets a restarted process skip the /points and stations requests. The file
+ * is versioned JSON; a file written by a different version is ignored.
+ */
+class EndpointCache {
+public:
+    static constexpr int FORMAT_VERSION = 2;  // 2: great-circle station ranking
+
+    explicit EndpointCache(const std::string& path);
+
+    // Resolved endpoints for the location, if present in the file
+    std::optional<ResolvedEndpoints> load(double latitude, double longitude) const;
+
+    // Add or replace the entry for endpoints' location. The file is
+    // rewritten through a temporary file and rename so a crash mid-write
+    // never leaves it truncated.
+    bool store(const ResolvedEndpoints& endpoints);
+
+    const std::string& path() const { return path_; }
+
+    // Key used for a location: coordinates at /points precision
+    static std::string locationKey(double latitude, double longitude);
+
+private:
+    std::string path_;
+    mutable std::mutex mutex_;  // Serialises read-modify-write of the file
+};
+
+#endif // ENDPOINT_CACHE_H
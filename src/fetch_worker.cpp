@@ -0,0 +1,122 @@
+#include "fetch_worker.h"
+#include <exception>
+#include <string>
+
+FetchWorker::FetchWorker(FetchFunction fetch)
+    : fetch_(std::move(fetch))
+    , running_(false)
+    , requested_(false)
+    , busy_(false)
+{
+}
+
+FetchWorker::~FetchWorker() {
+    stop();
+}
+
+void FetchWorker::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&FetchWorker::run, this);
+}
+
+void FetchWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+FetchWorker::ResultFuture FetchWorker::requestFetch(bool* coalesced) {
+    ResultFuture future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (coalesced) {
+            *coalesced = false;
+        }
+        if (!running_) {
+            std::promise<Result> stopped;
+            stopped.set_value(nullptr);
+            return stopped.get_future().share();
+        }
+        stats_.requests++;
+        if (busy_) {
+            stats_.coalesced++;
+            if (coalesced) {
+                *coalesced = true;
+            }
+            return pending_future_;
+        }
+        pending_ = std::make_shared<std::promise<Result>>();
+        pending_future_ = pending_->get_future().share();
+        future = pending_future_;
+        requested_ = true;
+        busy_ = true;
+    }
+    wake_.notify_one();
+    return future;
+}
+
+bool FetchWorker::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_;
+}
+
+std::shared_ptr<const WeatherData> FetchWorker::takeResult() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(published_);
+}
+
+FetchWorkerStats FetchWorker::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FetchWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return requested_ || !running_; });
+        if (!running_) {
+            // A fetch queued but not yet started is dropped
+            if (requested_) {
+                pending_->set_value(nullptr);
+                pending_.reset();
+            }
+            requested_ = false;
+            busy_ = false;
+            break;
+        }
+        requested_ = false;
+        stats_.fetches++;
+        
+        // The fetch itself runs unlocked so the main loop is never held up
+        lock.unlock();
+        WeatherData result;
+        try {
+            result = fetch_();
+        } catch (const std::exception& e) {
+            result.is_valid = false;
+            result.error_message = std::string("Fetch failed: ") + e.what();
+        }
+        auto data = std::make_shared<const WeatherData>(std::move(result));
+        lock.lock();
+        
+        // An older result the render loop has not taken is simply replaced
+        published_ = data;
+        busy_ = false;
+        
+        // Every request that joined this fetch gets the same result
+        pending_->set_value(std::move(data));
+        pending_.reset();
+    }
+}
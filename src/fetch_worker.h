@@ -0,0 +1,78 @@
+#ifndef FETCH_WORKER_H
+#define FETCH_WORKER_H
+
+#include "weather_data.h"
+#include <functional>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Fetch requests seen by a FetchWorker
+struct FetchWorkerStats {
+    uint64_t requests = 0;   // requestFetch() calls while running
+    uint64_t fetches = 0;    // Fetches actually run
+    uint64_t coalesced = 0;  // Requests that joined a queued or running fetch
+};
+
+/**
+ * Dedicated thread that runs weather fetches off the main loop.
+ * The worker fills a private WeatherData and publishes it as an immutable
+ * shared_ptr swapped in under a short lock, so the render loop picks up
+ * finished data without ever waiting on I/O.
+ *
+ * Requests are single-flight: any number of triggers (timer, buttons,
+ * other threads) asking while a fetch is queued or running attach to that
+ * fetch and receive its result instead of starting another.
+ */
+class FetchWorker {
+public:
+    using FetchFunction = std::function<WeatherData()>;
+    using Result = std::shared_ptr<const WeatherData>;
+    using ResultFuture = std::shared_future<Result>;
+
+    explicit FetchWorker(FetchFunction fetch);
+    ~FetchWorker();
+
+    void start();
+
+    // Waits for an in-flight fetch to finish before joining the thread
+    void stop();
+
+    // Queue a fetch, or join the one already queued or running. The future
+    // yields its result, or nullptr if the worker stopped before running it.
+    // *coalesced is set when the request joined an existing fetch.
+    ResultFuture requestFetch(bool* coalesced = nullptr);
+
+    // True while a fetch is queued or running
+    bool isBusy() const;
+
+    // Newest published result not yet taken, or nullptr
+    std::shared_ptr<const WeatherData> takeResult();
+
+    FetchWorkerStats getStats() const;
+
+private:
+    void run();
+
+    FetchFunction fetch_;
+    std::thread thread_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_;
+    bool requested_;
+    bool busy_;
+
+    // Result of the queued or running fetch, shared by every request for it
+    std::shared_ptr<std::promise<Result>> pending_;
+    ResultFuture pending_future_;
+    FetchWorkerStats stats_;
+
+    // Latest finished fetch, waiting for the render loop
+    std::shared_ptr<const WeatherData> published_;
+};
+
+#endif // FETCH_WORKER_H
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <cstdint>
+#include <algorithm>
+#include "text_layout.h"
 
 // Font alignment options
 enum class TextAlign {
@@ -17,7 +19,8 @@ enum class VerticalAlign {
     BOTTOM
 };
 
-// Font renderer class
+// Font renderer class. Fonts are generated Font descriptors, e.g.
+// draw_text<font_Inter_Regular_24::Font>(...); see text_layout.h.
 class FontRenderer {
 public:
     FontRenderer();
@@ -26,38 +29,120 @@ public:
     // Set the target buffer for rendering
     void set_target(uint8_t* buffer, int width, int height);
     
-    // Draw text at position with given color (palette index)
-    void draw_text(int x, int y, const std::string& text, uint8_t color,
-                   const uint8_t* font_atlas, int atlas_width, int atlas_height,
-                   const void* char_data, int char_count, int line_height, int baseline);
+    // Draw text at position with given color (palette index); '\n' starts a new line
+    template <typename Font>
+    void draw_text(int x, int y, const std::string& text, uint8_t color);
     
     // Draw text aligned within a rectangle
+    template <typename Font>
     void draw_text_aligned(int x, int y, int width, int height,
                           const std::string& text, uint8_t color,
-                          TextAlign h_align, VerticalAlign v_align,
-                          const uint8_t* font_atlas, int atlas_width, int atlas_height,
-                          const void* char_data, int char_count, int line_height, int baseline);
+                          TextAlign h_align, VerticalAlign v_align);
     
     // Measure text dimensions
-    void measure_text(const std::string& text,
-                     int& out_width, int& out_height,
-                     const void* char_data, int char_count, int line_height);
+    template <typename Font>
+    static void measure_text(const std::string& text, int& out_width, int& out_height);
     
 private:
-    // Helper to draw a single character
-    void draw_char(int x, int y, uint32_t codepoint, uint8_t color,
-                  const uint8_t* font_atlas, int atlas_width, int atlas_height,
-                  const void* char_data, int char_count);
-    
-    // Helper to find character data
-    const void* find_char_data(uint32_t codepoint, const void* char_data, int char_count);
-    
-    // UTF-8 decoding
-    uint32_t decode_utf8(const char*& str);
+    // Intersect with the target buffer; false if nothing is left to draw
+    bool clip(int& x, int& y, int& w, int& h) const;
     
     uint8_t* target_buffer_;
     int target_width_;
     int target_height_;
 };
 
-#endif // FONT_RENDERER_H
\ No newline at end of file
+template <typename Font>
+void FontRenderer::draw_text(int x, int y, const std::string& text, uint8_t color) {
+    if (!target_buffer_) {
+        return;
+    }
+    
+    int cursor_y = y + Font::baseline;  // Start at baseline
+    size_t line_start = 0;
+    while (line_start <= text.size()) {
+        size_t line_end = std::min(text.find('\n', line_start), text.size());
+        
+        int cursor_x = x;
+        for_each_glyph<Font>(text.substr(line_start, line_end - line_start),
+                             [&](const typename Font::Glyph* glyph) {
+            if (!glyph) {
+                return;
+            }
+            blit_glyph<Font>(*glyph, cursor_x, cursor_y,
+                [this](int& cx, int& cy, int& cw, int& ch) { return clip(cx, cy, cw, ch); },
+                [this, color](int sx, int sy, int length) {
+                    std::fill_n(target_buffer_ + sy * target_width_ + sx, length, color);
+                });
+            cursor_x += glyph->advance;
+        });
+        
+        cursor_y += Font::line_height;
+        line_start = line_end + 1;
+    }
+}
+
+template <typename Font>
+void FontRenderer::measure_text(const std::string& text, int& out_width, int& out_height) {
+    out_width = 0;
+    int lines = 0;
+    
+    size_t line_start = 0;
+    while (line_start <= text.size()) {
+        size_t line_end = std::min(text.find('\n', line_start), text.size());
+        
+        int current_width = 0;
+        for_each_glyph<Font>(text.substr(line_start, line_end - line_start),
+                             [&](const typename Font::Glyph* glyph) {
+            if (glyph) {
+                current_width += glyph->advance;
+            }
+        });
+        out_width = std::max(out_width, current_width);
+        
+        lines++;
+        line_start = line_end + 1;
+    }
+    
+    out_height = lines * Font::line_height;
+}
+
+template <typename Font>
+void FontRenderer::draw_text_aligned(int x, int y, int width, int height,
+                                    const std::string& text, uint8_t color,
+                                    TextAlign h_align, VerticalAlign v_align) {
+    // Measure text first
+    int text_width, text_height;
+    measure_text<Font>(text, text_width, text_height);
+    
+    // Calculate position based on alignment
+    int draw_x = x;
+    int draw_y = y;
+    
+    switch (h_align) {
+        case TextAlign::CENTER:
+            draw_x = x + (width - text_width) / 2;
+            break;
+        case TextAlign::RIGHT:
+            draw_x = x + width - text_width;
+            break;
+        default:
+            break;
+    }
+    
+    switch (v_align) {
+        case VerticalAlign::MIDDLE:
+            draw_y = y + (height - text_height) / 2;
+            break;
+        case VerticalAlign::BOTTOM:
+            draw_y = y + height - text_height;
+            break;
+        default:
+            break;
+    }
+    
+    // Draw the text at calculated position
+    draw_text<Font>(draw_x, draw_y, text, color);
+}
+
+#endif // FONT_RENDERER_H
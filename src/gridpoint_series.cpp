@@ -0,0 +1,270 @@
+#include "gridpoint_series.h"
+#include <algorithm>
+#include <numeric>
+#include <cstdio>
+#include <cctype>
+
+namespace {
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// "PT1H", "P7DT19H", "P1D", "PT30M"
+bool parseDuration(const std::string& text, int64_t& seconds) {
+    if (text.empty() || text[0] != 'P') {
+        return false;
+    }
+
+    seconds = 0;
+    bool in_time = false;
+    int64_t number = 0;
+    bool have_number = false;
+    for (size_t i = 1; i < text.size(); i++) {
+        char c = text[i];
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            number = number * 10 + (c - '0');
+            have_number = true;
+            continue;
+        }
+        if (c == 'T') {
+            in_time = true;
+            continue;
+        }
+        if (!have_number) {
+            return false;
+        }
+        switch (c) {
+            case 'W': seconds += number * 7 * 86400; break;
+            case 'D': seconds += number * 86400; break;
+            case 'H': seconds += number * 3600; break;
+            case 'M': seconds += in_time ? number * 60 : number * 30 * 86400; break;
+            case 'S': seconds += number; break;
+            default: return false;
+        }
+        number = 0;
+        have_number = false;
+    }
+    return !have_number && seconds > 0;
+}
+
+template <typename T>
+void applyOrder(std::vector<T>& values, const std::vector<size_t>& order) {
+    std::vector<T> sorted;
+    sorted.reserve(values.size());
+    for (size_t i : order) {
+        sorted.push_back(std::move(values[i]));
+    }
+    values = std::move(sorted);
+}
+
+} // namespace
+
+bool parseIsoTimestamp(const std::string& text, int64_t& epoch) {
+    int year, month, day, hour, minute, second = 0;
+    int consumed = 0;
+    if (std::sscanf(text.c_str(), "%4d-%2d-%2dT%2d:%2d%n", &year, &month, &day, &hour, &minute, &consumed) != 5) {
+        return false;
+    }
+    size_t pos = static_cast<size_t>(consumed);
+    if (pos < text.size() && text[pos] == ':') {
+        int seconds_consumed = 0;
+        if (std::sscanf(text.c_str() + pos, ":%2d%n", &second, &seconds_consumed) != 1) {
+            return false;
+        }
+        pos += seconds_consumed;
+    }
+
+    int64_t offset = 0;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        int offset_hours = 0, offset_minutes = 0;
+        if (std::sscanf(text.c_str() + pos + 1, "%2d:%2d", &offset_hours, &offset_minutes) < 1) {
+            return false;
+        }
+        offset = (offset_hours * 60 + offset_minutes) * 60;
+        if (text[pos] == '-') {
+            offset = -offset;
+        }
+    } else if (pos < text.size() && text[pos] != 'Z') {
+        return false;
+    }
+
+    epoch = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return true;
+}
+
+bool parseValidTime(const std::string& valid_time, int64_t& start, int64_t& end) {
+    size_t slash = valid_time.find('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+
+    int64_t duration = 0;
+    if (!parseIsoTimestamp(valid_time.substr(0, slash), start) ||
+        !parseDuration(valid_time.substr(slash + 1), duration)) {
+        return false;
+    }
+    end = start + duration;
+    return true;
+}
+
+std::pair<int64_t, int64_t> localDayWindow(std::time_t t) {
+    std::tm tm = {};
+    localtime_r(&t, &tm);
+    tm.tm_hour = 0;
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    std::time_t day_start = std::mktime(&tm);
+
+    // mktime normalises the day overflow and handles DST-length days
+    tm.tm_mday += 1;
+    tm.tm_isdst = -1;
+    std::time_t day_end = std::mktime(&tm);
+
+    return {static_cast<int64_t>(day_start), static_cast<int64_t>(day_end)};
+}
+
+void IntervalIndex::append(int64_t start, int64_t end) {
+    if (!starts_.empty() && start < ends_.back()) {
+        sorted_ = false;
+    }
+    starts_.push_back(start);
+    ends_.push_back(end);
+}
+
+int IntervalIndex::find(int64_t t) const {
+    auto it = std::upper_bound(starts_.begin(), starts_.end(), t);
+    if (it == starts_.begin()) {
+        return -1;
+    }
+    size_t i = static_cast<size_t>(it - starts_.begin()) - 1;
+    return t < ends_[i] ? static_cast<int>(i) : -1;
+}
+
+std::pair<size_t, size_t> IntervalIndex::overlapping(int64_t from, int64_t to) const {
+    // Intervals are sorted and non-overlapping, so ends are sorted too
+    size_t first = static_cast<size_t>(std::upper_bound(ends_.begin(), ends_.end(), from) - ends_.begin());
+    size_t last = static_cast<size_t>(std::lower_bound(starts_.begin(), starts_.end(), to) - starts_.begin());
+    return {first, std::max(first, last)};
+}
+
+std::vector<size_t> IntervalIndex::sortOrder() const {
+    std::vector<size_t> order(starts_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return starts_[a] < starts_[b];
+    });
+    return order;
+}
+
+void IntervalIndex::reorder(const std::vector<size_t>& order) {
+    applyOrder(starts_, order);
+    applyOrder(ends_, order);
+    sorted_ = true;
+}
+
+void TimeSeries::append(int64_t start, int64_t end, double value) {
+    index.append(start, end);
+    values.push_back(value);
+}
+
+void TimeSeries::sort() {
+    if (index.isSorted()) {
+        return;
+    }
+    auto order = index.sortOrder();
+    index.reorder(order);
+    applyOrder(values, order);
+}
+
+std::optional<double> TimeSeries::valueAt(int64_t t) const {
+    int i = index.find(t);
+    if (i < 0) {
+        return std::nullopt;
+    }
+    return values[i];
+}
+
+std::optional<double> TimeSeries::maxOver(int64_t from, int64_t to) const {
+    auto range = index.overlapping(from, to);
+    if (range.first == range.second) {
+        return std::nullopt;
+    }
+    return *std::max_element(values.begin() + range.first, values.begin() + range.second);
+}
+
+std::optional<double> TimeSeries::minOver(int64_t from, int64_t to) const {
+    auto range = index.overlapping(from, to);
+    if (range.first == range.second) {
+        return std::nullopt;
+    }
+    return *std::min_element(values.begin() + range.first, values.begin() + range.second);
+}
+
+void ConditionSeries::append(int64_t start, int64_t end, const std::string& condition,
+                             const std::string& condition_intensity) {
+    index.append(start, end);
+    weather.push_back(condition);
+    intensity.push_back(condition_intensity);
+}
+
+void ConditionSeries::sort() {
+    if (index.isSorted()) {
+        return;
+    }
+    auto order = index.sortOrder();
+    index.reorder(order);
+    applyOrder(weather, order);
+    applyOrder(intensity, order);
+}
+
+void GridpointSeries::finalize() {
+    temperature.sort();
+    max_temperature.sort();
+    min_temperature.sort();
+    precipitation_chance.sort();
+    sky_cover.sort();
+    weather.sort();
+}
+
+NWSForecast GridpointSeries::forecastAt(std::time_t now) const {
+    NWSForecast forecast;
+    forecast.valid = true;
+
+    int64_t t = static_cast<int64_t>(now);
+    auto day = localDayWindow(now);
+
+    // Prefer the daily max/min series; fall back to the hourly temperatures
+    forecast.temperature_max_celsius = max_temperature.maxOver(day.first, day.second);
+    if (!forecast.temperature_max_celsius.has_value()) {
+        forecast.temperature_max_celsius = temperature.maxOver(day.first, day.second);
+    }
+    forecast.temperature_min_celsius = min_temperature.minOver(day.first, day.second);
+    if (!forecast.temperature_min_celsius.has_value()) {
+        forecast.temperature_min_celsius = temperature.minOver(day.first, day.second);
+    }
+
+    auto precipitation = precipitation_chance.valueAt(t);
+    if (precipitation.has_value()) {
+        forecast.precipitation_chance_percent = static_cast<int>(precipitation.value());
+    }
+    auto sky = sky_cover.valueAt(t);
+    if (sky.has_value()) {
+        forecast.sky_cover_percent = static_cast<int>(sky.value());
+    }
+
+    int condition = weather.index.find(t);
+    if (condition >= 0) {
+        forecast.weather_condition = weather.weather[condition];
+        forecast.weather_intensity = weather.intensity[condition];
+    }
+
+    return forecast;
+}
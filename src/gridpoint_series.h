@@ -0,0 +1,99 @@
+#ifndef GRIDPOINT_SERIES_H
+#define GRIDPOINT_SERIES_H
+
+#include "nws_client.h"
+#include <string>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * Sorted, non-overlapping [start, end) intervals in epoch seconds, parsed
+ * once from NWS validTime strings so lookups are binary searches.
+ */
+class IntervalIndex {
+public:
+    void append(int64_t start, int64_t end);
+
+    // Index of the interval containing t, or -1
+    int find(int64_t t) const;
+
+    // Half-open index range [first, last) of intervals overlapping [from, to)
+    std::pair<size_t, size_t> overlapping(int64_t from, int64_t to) const;
+
+    size_t size() const { return starts_.size(); }
+    bool empty() const { return starts_.empty(); }
+    bool isSorted() const { return sorted_; }
+    int64_t start(size_t i) const { return starts_[i]; }
+    int64_t end(size_t i) const { return ends_[i]; }
+
+    // Order of the intervals by start time, for callers that need to sort
+    // parallel value arrays
+    std::vector<size_t> sortOrder() const;
+    void reorder(const std::vector<size_t>& order);
+
+private:
+    std::vector<int64_t> starts_;
+    std::vector<int64_t> ends_;
+    bool sorted_ = true;
+};
+
+// Numeric gridpoint series such as temperature or skyCover
+struct TimeSeries {
+    IntervalIndex index;
+    std::vector<double> values;
+
+    void append(int64_t start, int64_t end, double value);
+    void sort();
+
+    std::optional<double> valueAt(int64_t t) const;
+    std::optional<double> maxOver(int64_t from, int64_t to) const;
+    std::optional<double> minOver(int64_t from, int64_t to) const;
+};
+
+// The weather series: first condition of each interval
+struct ConditionSeries {
+    IntervalIndex index;
+    std::vector<std::string> weather;
+    std::vector<std::string> intensity;
+
+    void append(int64_t start, int64_t end, const std::string& condition, const std::string& condition_intensity);
+    void sort();
+};
+
+/**
+ * Every series needed from /gridpoints/{office}/{x},{y}, indexed by time.
+ * Built once per download and cached with the response, so repeated
+ * queries until the next fetch do no string parsing.
+ */
+struct GridpointSeries {
+    TimeSeries temperature;
+    TimeSeries max_temperature;
+    TimeSeries min_temperature;
+    TimeSeries precipitation_chance;
+    TimeSeries sky_cover;
+    ConditionSeries weather;
+    int64_t update_time = 0;  // properties.updateTime in epoch seconds; 0 if absent
+
+    // Sort any series that arrived out of order
+    void finalize();
+
+    // Values in effect at now, with today's high/low taken over the local
+    // calendar day containing now
+    NWSForecast forecastAt(std::time_t now) const;
+};
+
+// Parse an ISO-8601 timestamp such as "2024-06-01T06:00:00-05:00" into
+// epoch seconds
+bool parseIsoTimestamp(const std::string& text, int64_t& epoch);
+
+// Parse an ISO-8601 "start/duration" validTime such as
+// "2024-06-01T06:00:00+00:00/PT3H" into epoch seconds
+bool parseValidTime(const std::string& valid_time, int64_t& start, int64_t& end);
+
+// [start, end) epoch seconds of the local calendar day containing t
+std::pair<int64_t, int64_t> localDayWindow(std::time_t t);
+
+#endif // GRIDPOINT_SERIES_H
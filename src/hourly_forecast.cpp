@@ -0,0 +1,106 @@
+#include "hourly_forecast.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+template <typename T>
+T clampTo(double value, T missing) {
+    double lo = static_cast<double>(std::numeric_limits<T>::min());
+    double hi = static_cast<double>(std::numeric_limits<T>::max());
+    // The sentinel sits at one end of the range; keep real values off it
+    if (missing == std::numeric_limits<T>::min()) {
+        lo += 1;
+    } else {
+        hi -= 1;
+    }
+    return static_cast<T>(std::lround(std::clamp(value, lo, hi)));
+}
+
+} // namespace
+
+void HourlyForecast::resize(size_t rows) {
+    temperature_dc_.resize(rows, MISSING_I16);
+    precipitation_.resize(rows, MISSING_U8);
+    wind_speed_dkmh_.resize(rows, MISSING_U16);
+    wind_direction_.resize(rows, MISSING_I16);
+    icon_code_.resize(rows, MISSING_U8);
+    humidity_.resize(rows, MISSING_U8);
+}
+
+void HourlyForecast::append(const HourlyPoint& point) {
+    int64_t t = static_cast<int64_t>(point.time);
+    if (empty()) {
+        start_ = floorDiv(t, HOUR_SECONDS) * HOUR_SECONDS;
+    }
+
+    int64_t row = floorDiv(t - start_, HOUR_SECONDS);
+    if (row < 0) {
+        return;  // Periods arrive in order; ignore anything before the first
+    }
+    if (static_cast<size_t>(row) >= size()) {
+        resize(static_cast<size_t>(row) + 1);
+    }
+
+    size_t i = static_cast<size_t>(row);
+    if (point.temperature_c) temperature_dc_[i] = clampTo<int16_t>(*point.temperature_c * 10.0, MISSING_I16);
+    if (point.precipitation_percent) precipitation_[i] = clampTo<uint8_t>(*point.precipitation_percent, MISSING_U8);
+    if (point.wind_speed_kmh) wind_speed_dkmh_[i] = clampTo<uint16_t>(*point.wind_speed_kmh * 10.0, MISSING_U16);
+    if (point.wind_direction_deg) wind_direction_[i] = clampTo<int16_t>(*point.wind_direction_deg, MISSING_I16);
+    if (point.icon_code) icon_code_[i] = clampTo<uint8_t>(*point.icon_code, MISSING_U8);
+    if (point.humidity_percent) humidity_[i] = clampTo<uint8_t>(*point.humidity_percent, MISSING_U8);
+}
+
+int HourlyForecast::indexAt(std::time_t t) const {
+    if (empty()) {
+        return -1;
+    }
+    int64_t row = floorDiv(static_cast<int64_t>(t) - start_, HOUR_SECONDS);
+    if (row < 0 || static_cast<size_t>(row) >= size()) {
+        return -1;
+    }
+    return static_cast<int>(row);
+}
+
+std::pair<size_t, size_t> HourlyForecast::slice(std::time_t from, size_t hours) const {
+    int64_t row = empty() ? 0 : floorDiv(static_cast<int64_t>(from) - start_, HOUR_SECONDS);
+    size_t first = static_cast<size_t>(std::clamp<int64_t>(row, 0, static_cast<int64_t>(size())));
+    size_t last = std::min(size(), first + hours);
+    return {first, last};
+}
+
+HourlyPoint HourlyForecast::at(size_t i) const {
+    HourlyPoint point;
+    point.time = timeAt(i);
+    if (temperature_dc_[i] != MISSING_I16) point.temperature_c = temperature_dc_[i] / 10.0;
+    if (precipitation_[i] != MISSING_U8) point.precipitation_percent = precipitation_[i];
+    if (wind_speed_dkmh_[i] != MISSING_U16) point.wind_speed_kmh = wind_speed_dkmh_[i] / 10.0;
+    if (wind_direction_[i] != MISSING_I16) point.wind_direction_deg = wind_direction_[i];
+    if (icon_code_[i] != MISSING_U8) point.icon_code = icon_code_[i];
+    if (humidity_[i] != MISSING_U8) point.humidity_percent = humidity_[i];
+    return point;
+}
+
+size_t HourlyForecast::memoryBytes() const {
+    return temperature_dc_.capacity() * sizeof(int16_t) +
+           precipitation_.capacity() * sizeof(uint8_t) +
+           wind_speed_dkmh_.capacity() * sizeof(uint16_t) +
+           wind_direction_.capacity() * sizeof(int16_t) +
+           icon_code_.capacity() * sizeof(uint8_t) +
+           humidity_.capacity() * sizeof(uint8_t);
+}
+
+void HourlyForecast::shrinkToFit() {
+    temperature_dc_.shrink_to_fit();
+    precipitation_.shrink_to_fit();
+    wind_speed_dkmh_.shrink_to_fit();
+    wind_direction_.shrink_to_fit();
+    icon_code_.shrink_to_fit();
+    humidity_.shrink_to_fit();
+}
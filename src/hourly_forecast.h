@@ -0,0 +1,78 @@
+#ifndef HOURLY_FORECAST_H
+#define HOURLY_FORECAST_H
+
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+
+// One hour of forecast, unpacked from the columns
+struct HourlyPoint {
+    std::time_t time = 0;
+    std::optional<double> temperature_c;
+    std::optional<int> precipitation_percent;
+    std::optional<double> wind_speed_kmh;
+    std::optional<int> wind_direction_deg;
+    std::optional<int> icon_code;          // Numbered weather icon (see weather_icons.h)
+    std::optional<int> humidity_percent;
+};
+
+/**
+ * Struct-of-arrays store for /forecast/hourly.
+ * Hours are kept on a regular one-hour grid starting at startTime(), so the
+ * epoch column is implicit and the row for any time is a single division.
+ * Every column is a fixed-width integer with a sentinel for missing values.
+ */
+class HourlyForecast {
+public:
+    static constexpr int64_t HOUR_SECONDS = 3600;
+
+    static constexpr int16_t MISSING_I16 = INT16_MIN;
+    static constexpr uint16_t MISSING_U16 = UINT16_MAX;
+    static constexpr uint8_t MISSING_U8 = UINT8_MAX;
+
+    // Add an hour; periods may arrive with gaps, which are left missing
+    void append(const HourlyPoint& point);
+
+    size_t size() const { return temperature_dc_.size(); }
+    bool empty() const { return temperature_dc_.empty(); }
+
+    std::time_t startTime() const { return static_cast<std::time_t>(start_); }
+    std::time_t timeAt(size_t i) const { return static_cast<std::time_t>(start_ + static_cast<int64_t>(i) * HOUR_SECONDS); }
+
+    // Row containing t, or -1 outside the forecast
+    int indexAt(std::time_t t) const;
+
+    // Row range [first, last) for up to hours rows starting at the hour containing from
+    std::pair<size_t, size_t> slice(std::time_t from, size_t hours) const;
+
+    HourlyPoint at(size_t i) const;
+
+    // Raw columns for renderers that want to walk a slice without unpacking
+    const std::vector<int16_t>& temperatureDeciC() const { return temperature_dc_; }
+    const std::vector<uint8_t>& precipitationPercent() const { return precipitation_; }
+    const std::vector<uint16_t>& windSpeedDeciKmh() const { return wind_speed_dkmh_; }
+    const std::vector<int16_t>& windDirectionDeg() const { return wind_direction_; }
+    const std::vector<uint8_t>& iconCode() const { return icon_code_; }
+    const std::vector<uint8_t>& humidityPercent() const { return humidity_; }
+
+    // Heap bytes held by the columns
+    size_t memoryBytes() const;
+
+    void shrinkToFit();
+
+private:
+    void resize(size_t rows);
+
+    int64_t start_ = 0;
+    std::vector<int16_t> temperature_dc_;   // 0.1 degC
+    std::vector<uint8_t> precipitation_;    // percent
+    std::vector<uint16_t> wind_speed_dkmh_; // 0.1 km/h
+    std::vector<int16_t> wind_direction_;   // degrees
+    std::vector<uint8_t> icon_code_;
+    std::vector<uint8_t> humidity_;         // percent
+};
+
+#endif // HOURLY_FORECAST_H
@@ -0,0 +1,61 @@
+#include "http_transport.h"
+#include <httplib.h>
+#include <strings.h>
+
+std::string TransportResponse::header(const std::string& name) const {
+    for (const auto& header : headers) {
+        if (strcasecmp(header.first.c_str(), name.c_str()) == 0) {
+            return header.second;
+        }
+    }
+    return "";
+}
+
+LiveTransport::LiveTransport(const std::string& base_url)
+    : pool_(base_url)
+{
+}
+
+bool LiveTransport::get(const std::string& path, const Headers& headers,
+                        const ResponseHandler& on_response, const ContentHandler& on_content,
+                        TransportResponse& response, std::string& error) {
+    httplib::Headers request_headers(headers.begin(), headers.end());
+    
+    auto lease = pool_.acquire();
+    bool reused = lease.isConnected();
+    pool_.recordRequest(reused);
+    
+    // Content-Encoding is left to the caller so wire bytes can be counted
+    lease.client().set_decompress(false);
+    
+    auto response_handler = [&](const httplib::Response& res) {
+        response.status = res.status;
+        response.reason = res.reason;
+        response.headers.assign(res.headers.begin(), res.headers.end());
+        return on_response(response);
+    };
+    auto content_receiver = [&](const char* data, size_t length) {
+        return on_content(data, length);
+    };
+    
+    auto res = lease.client().Get(path, request_headers, response_handler, content_receiver);
+    
+    // A kept-alive socket may have been closed by the server while idle.
+    // Reconnect once before treating this as a network failure.
+    if (!res && reused && res.error() != httplib::Error::Canceled) {
+        pool_.recordReconnect();
+        lease.reset();
+        res = lease.client().Get(path, request_headers, response_handler, content_receiver);
+    }
+    
+    if (!res) {
+        error = httplib::to_string(res.error());
+        lease.reset();
+        return false;
+    }
+    
+    // Redirects are followed, so report the final response
+    response.status = res->status;
+    response.reason = res->reason;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef HTTP_TRANSPORT_H
+#define HTTP_TRANSPORT_H
+
+#include "connection_pool.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+// Status line and headers of one response, as received
+struct TransportResponse {
+    int status = 0;
+    std::string reason;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    // Case-insensitive header lookup; empty if absent
+    std::string header(const std::string& name) const;
+};
+
+/**
+ * Moves one GET request and its raw (still content-encoded) body between
+ * NWSClient and a server. Implementations must be safe to call from
+ * several threads at once.
+ */
+class HttpTransport {
+public:
+    using Headers = std::vector<std::pair<std::string, std::string>>;
+
+    // Called once the status and headers are in; returning false aborts
+    using ResponseHandler = std::function<bool(const TransportResponse& response)>;
+
+    // Called for each chunk of body bytes; returning false aborts
+    using ContentHandler = std::function<bool(const char* data, size_t length)>;
+
+    virtual ~HttpTransport() = default;
+
+    // GET path. On success response holds the status and headers; on a
+    // network failure or abort returns false with error set.
+    virtual bool get(const std::string& path, const Headers& headers,
+                     const ResponseHandler& on_response, const ContentHandler& on_content,
+                     TransportResponse& response, std::string& error) = 0;
+
+    virtual void setTimeout(int timeout_seconds) { (void)timeout_seconds; }
+    virtual ConnectionStats getConnectionStats() const { return ConnectionStats(); }
+};
+
+/**
+ * Transport over real sockets, using keep-alive connections from a pool.
+ */
+class LiveTransport : public HttpTransport {
+public:
+    explicit LiveTransport(const std::string& base_url);
+
+    bool get(const std::string& path, const Headers& headers,
+             const ResponseHandler& on_response, const ContentHandler& on_content,
+             TransportResponse& response, std::string& error) override;
+
+    void setTimeout(int timeout_seconds) override { pool_.setTimeout(timeout_seconds); }
+    ConnectionStats getConnectionStats() const override { return pool_.getStats(); }
+
+private:
+    ConnectionPool pool_;
+};
+
+#endif // HTTP_TRANSPORT_H
@@ -0,0 +1,216 @@
+#include "json_schema_decoder.h"
+#include <sstream>
+
+JsonSchema::JsonSchema() {
+    nodes_.emplace_back();  // Root
+}
+
+JsonSchema& JsonSchema::field(const std::string& path, int field_id) {
+    nodes_[resolve(path)].field_id = field_id;
+    return *this;
+}
+
+JsonSchema& JsonSchema::record(const std::string& path, int record_id) {
+    nodes_[resolve(path)].record_id = record_id;
+    return *this;
+}
+
+int JsonSchema::child(int node, const std::string& key) const {
+    if (node == NONE) {
+        return NONE;
+    }
+    const auto& children = nodes_[node].children;
+    auto it = children.find(key);
+    return it != children.end() ? it->second : NONE;
+}
+
+int JsonSchema::resolve(const std::string& path) {
+    int current = root();
+    if (path.empty()) {
+        return current;
+    }
+
+    std::stringstream ss(path);
+    std::string segment;
+    while (std::getline(ss, segment, '.')) {
+        int next = (segment == "*") ? nodes_[current].element : child(current, segment);
+        if (next == NONE) {
+            next = static_cast<int>(nodes_.size());
+            nodes_.emplace_back();
+            if (segment == "*") {
+                nodes_[current].element = next;
+            } else {
+                nodes_[current].children[segment] = next;
+            }
+        }
+        current = next;
+    }
+    return current;
+}
+
+SchemaSaxDecoder::SchemaSaxDecoder(const JsonSchema& schema)
+    : schema_(schema)
+    , key_node_(JsonSchema::NONE)
+    , stopped_(false)
+{
+}
+
+bool SchemaSaxDecoder::parse(const std::string& input) {
+    stack_.clear();
+    key_node_ = JsonSchema::NONE;
+    stopped_ = false;
+    error_.clear();
+
+    bool ok = nlohmann::json::sax_parse(input, this);
+    return ok || stopped_;
+}
+
+bool SchemaSaxDecoder::parse(std::istream& input) {
+    stack_.clear();
+    key_node_ = JsonSchema::NONE;
+    stopped_ = false;
+    error_.clear();
+
+    bool ok = nlohmann::json::sax_parse(input, this);
+    return ok || stopped_;
+}
+
+size_t SchemaSaxDecoder::elementIndex(size_t levels) const {
+    for (auto it = stack_.rbegin(); it != stack_.rend(); ++it) {
+        if (!it->is_array) {
+            continue;
+        }
+        if (levels == 0) {
+            return it->count > 0 ? it->count - 1 : 0;
+        }
+        levels--;
+    }
+    return 0;
+}
+
+bool SchemaSaxDecoder::stop() {
+    stopped_ = true;
+    return false;
+}
+
+int SchemaSaxDecoder::nextNode() {
+    if (stack_.empty()) {
+        return schema_.root();
+    }
+
+    Frame& top = stack_.back();
+    if (top.is_array) {
+        top.count++;
+        return schema_.element(top.node);
+    }
+    return key_node_;
+}
+
+bool SchemaSaxDecoder::scalar(const Value& value) {
+    int node = nextNode();
+    if (node == JsonSchema::NONE) {
+        return true;
+    }
+
+    int field_id = schema_.node(node).field_id;
+    if (field_id == JsonSchema::NONE) {
+        return true;
+    }
+    return onField(field_id, value) || stop();
+}
+
+bool SchemaSaxDecoder::null() {
+    return scalar(Value());
+}
+
+bool SchemaSaxDecoder::boolean(bool val) {
+    Value value;
+    value.type = Value::Type::Boolean;
+    value.boolean = val;
+    return scalar(value);
+}
+
+bool SchemaSaxDecoder::number_integer(number_integer_t val) {
+    Value value;
+    value.type = Value::Type::Number;
+    value.number = static_cast<double>(val);
+    return scalar(value);
+}
+
+bool SchemaSaxDecoder::number_unsigned(number_unsigned_t val) {
+    Value value;
+    value.type = Value::Type::Number;
+    value.number = static_cast<double>(val);
+    return scalar(value);
+}
+
+bool SchemaSaxDecoder::number_float(number_float_t val, const string_t&) {
+    Value value;
+    value.type = Value::Type::Number;
+    value.number = val;
+    return scalar(value);
+}
+
+bool SchemaSaxDecoder::string(string_t& val) {
+    Value value;
+    value.type = Value::Type::String;
+    value.string = &val;
+    return scalar(value);
+}
+
+bool SchemaSaxDecoder::binary(binary_t&) {
+    // Not produced by the JSON parser
+    return true;
+}
+
+bool SchemaSaxDecoder::start_object(std::size_t) {
+    int node = nextNode();
+    stack_.push_back({node, false, 0});
+    key_node_ = JsonSchema::NONE;
+
+    if (node != JsonSchema::NONE && schema_.node(node).record_id != JsonSchema::NONE) {
+        return onRecordStart(schema_.node(node).record_id) || stop();
+    }
+    return true;
+}
+
+bool SchemaSaxDecoder::key(string_t& val) {
+    key_node_ = schema_.child(stack_.back().node, val);
+    return true;
+}
+
+bool SchemaSaxDecoder::end_object() {
+    int node = stack_.back().node;
+    stack_.pop_back();
+
+    if (node != JsonSchema::NONE && schema_.node(node).record_id != JsonSchema::NONE) {
+        return onRecordEnd(schema_.node(node).record_id) || stop();
+    }
+    return true;
+}
+
+bool SchemaSaxDecoder::start_array(std::size_t) {
+    int node = nextNode();
+    stack_.push_back({node, true, 0});
+
+    if (node != JsonSchema::NONE && schema_.node(node).record_id != JsonSchema::NONE) {
+        return onRecordStart(schema_.node(node).record_id) || stop();
+    }
+    return true;
+}
+
+bool SchemaSaxDecoder::end_array() {
+    int node = stack_.back().node;
+    stack_.pop_back();
+
+    if (node != JsonSchema::NONE && schema_.node(node).record_id != JsonSchema::NONE) {
+        return onRecordEnd(schema_.node(node).record_id) || stop();
+    }
+    return true;
+}
+
+bool SchemaSaxDecoder::parse_error(std::size_t position, const std::string&,
+                                   const nlohmann::detail::exception& ex) {
+    error_ = "JSON parse error at byte " + std::to_string(position) + ": " + ex.what();
+    return false;
+}
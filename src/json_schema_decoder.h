@@ -0,0 +1,129 @@
+#ifndef JSON_SCHEMA_DECODER_H
+#define JSON_SCHEMA_DECODER_H
+
+#include <string>
+#include <istream>
+#include <vector>
+#include <map>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+/**
+ * Tree of the JSON paths a decoder cares about.
+ * Paths are dot separated object keys, with "*" standing for any array
+ * element, e.g. "features.*.properties.temperature.value". Everything not
+ * reachable through a registered path is skipped by the decoder.
+ */
+class JsonSchema {
+public:
+    static constexpr int NONE = -1;
+
+    struct Node {
+        std::map<std::string, int> children;  // Object key -> node
+        int element = NONE;                   // Node for array elements
+        int field_id = NONE;                  // Scalar value reported to the decoder
+        int record_id = NONE;                 // Object/array whose start and end are reported
+    };
+
+    JsonSchema();
+
+    // Report the scalar at path to SchemaSaxDecoder::onField with field_id
+    JsonSchema& field(const std::string& path, int field_id);
+
+    // Report start and end of the object or array at path with record_id
+    JsonSchema& record(const std::string& path, int record_id);
+
+    int root() const { return 0; }
+    int child(int node, const std::string& key) const;
+    int element(int node) const { return node == NONE ? NONE : nodes_[node].element; }
+    const Node& node(int index) const { return nodes_[index]; }
+
+private:
+    int resolve(const std::string& path);
+
+    std::vector<Node> nodes_;
+};
+
+/**
+ * SAX handler that walks a JsonSchema while nlohmann::json tokenizes the
+ * input. Only scalars at registered paths reach the derived decoder, no DOM
+ * is built, and a decoder can stop parsing as soon as it has what it needs.
+ */
+class SchemaSaxDecoder : public nlohmann::json_sax<nlohmann::json> {
+public:
+    // A scalar JSON value; string points into the parser's buffer and is
+    // only valid for the duration of the callback
+    struct Value {
+        enum class Type { Null, Boolean, Number, String };
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0.0;
+        const std::string* string = nullptr;
+
+        bool isNull() const { return type == Type::Null; }
+        bool isNumber() const { return type == Type::Number; }
+        bool isString() const { return type == Type::String; }
+    };
+
+    explicit SchemaSaxDecoder(const JsonSchema& schema);
+    ~SchemaSaxDecoder() override = default;
+
+    // Parse a complete document. Returns true on success or when the decoder
+    // stopped early; false on malformed input (see error()).
+    bool parse(const std::string& input);
+
+    // Parse from a stream, e.g. a BodyStream still being received
+    bool parse(std::istream& input);
+
+    bool stoppedEarly() const { return stopped_; }
+    const std::string& error() const { return error_; }
+
+    // nlohmann::json_sax interface
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+
+protected:
+    // Called for every scalar at a registered field path. Return false to stop.
+    virtual bool onField(int field_id, const Value& value) = 0;
+
+    // Called when a registered record starts and ends. Return false to stop.
+    virtual bool onRecordStart(int record_id) { (void)record_id; return true; }
+    virtual bool onRecordEnd(int record_id) { (void)record_id; return true; }
+
+    // Index of the current value within its enclosing array; levels counts
+    // further enclosing arrays outwards
+    size_t elementIndex(size_t levels = 0) const;
+
+    // Stop parsing; the decode still counts as successful
+    bool stop();
+
+private:
+    struct Frame {
+        int node;
+        bool is_array;
+        size_t count;  // Elements seen so far (arrays only)
+    };
+
+    int nextNode();
+    bool scalar(const Value& value);
+
+    const JsonSchema& schema_;
+    std::vector<Frame> stack_;
+    int key_node_;
+    bool stopped_;
+    std::string error_;
+};
+
+#endif // JSON_SCHEMA_DECODER_H
@@ -91,7 +91,10 @@ std::string Logger::getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
     
+    std::tm local_tm = {};
+    localtime_r(&time_t, &local_tm);
+    
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    ss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S");
     return ss.str();
 }
\ No newline at end of file
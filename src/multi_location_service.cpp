@@ -0,0 +1,432 @@
+#include "multi_location_service.h"
+#include "weather_service.h"
+#include "hourly_forecast.h"
+#include "gridpoint_series.h"
+#include "detached_task.h"
+#include "station_index.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <map>
+#include <set>
+
+namespace {
+
+// Identity of a forecast grid; locations with the same key share forecasts
+std::string gridKey(const NWSPoints& points) {
+    if (points.office_id.empty()) {
+        return points.forecast_grid_url;
+    }
+    return points.office_id + "/" + std::to_string(points.grid_x) + "," + std::to_string(points.grid_y);
+}
+
+// Requests shared by every location on one grid
+struct GridFetch {
+    std::string grid_url;
+    std::string forecast_url;
+    std::string hourly_url;
+    std::future<std::shared_ptr<const GridpointSeries>> series;
+    std::future<NWSForecast> icon;
+    std::future<std::shared_ptr<const HourlyForecast>> hourly;
+    bool failed = false;  // A due forecast fetch failed; held data is stale
+};
+
+// True if two results would render the same; a refresh that changes
+// nothing keeps the earlier timestamp so the display can skip its refresh
+bool sameReading(const WeatherData& a, const WeatherData& b) {
+    return a.is_valid && b.is_valid &&
+           a.temperature_c == b.temperature_c &&
+           a.humidity_percent == b.humidity_percent &&
+           a.wind_speed_kmh == b.wind_speed_kmh &&
+           a.wind_direction_deg == b.wind_direction_deg &&
+           a.dewpoint_c == b.dewpoint_c &&
+           a.temperature_max_c == b.temperature_max_c &&
+           a.temperature_min_c == b.temperature_min_c &&
+           a.precipitation_chance_percent == b.precipitation_chance_percent &&
+           a.weather_icon == b.weather_icon &&
+           a.weather_description == b.weather_description &&
+           a.hourly == b.hourly;
+}
+
+} // namespace
+
+MultiLocationService::MultiLocationService()
+    : client_(std::make_shared<NWSClient>())
+    , fetch_timeout_seconds_(30)
+    , hourly_forecast_enabled_(false)
+    , stats_logging_(false)
+    , endpoint_revalidate_hours_(24)
+{
+}
+
+MultiLocationService::~MultiLocationService() {
+}
+
+size_t MultiLocationService::addLocation(const std::string& name, double latitude, double longitude) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Location location;
+    location.name = name;
+    location.latitude = latitude;
+    location.longitude = longitude;
+    location.stations = std::make_shared<StationIndex>();
+    locations_.push_back(location);
+    results_.emplace_back();
+    return locations_.size() - 1;
+}
+
+size_t MultiLocationService::locationCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return locations_.size();
+}
+
+std::string MultiLocationService::locationName(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index < locations_.size() ? locations_[index].name : std::string();
+}
+
+WeatherData MultiLocationService::getWeatherData(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= results_.size()) {
+        WeatherData data;
+        data.error_message = "No location at index " + std::to_string(index);
+        return data;
+    }
+    return results_[index];
+}
+
+void MultiLocationService::setEndpointCacheFile(const std::string& path) {
+    if (path.empty()) {
+        endpoint_cache_.reset();
+    } else {
+        endpoint_cache_ = std::make_shared<EndpointCache>(path);
+    }
+}
+
+std::string MultiLocationService::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
+
+MultiLocationStats MultiLocationService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MultiLocationService::resolveLocations(std::vector<Location>& locations) {
+    std::time_t now = std::time(nullptr);
+    // New endpoints per location index, applied once their stations arrive
+    std::map<size_t, ResolvedEndpoints> resolving;
+    // Locations waiting for a station list, by stations URL
+    std::map<std::string, std::vector<size_t>> pending_stations;
+    
+    for (size_t i = 0; i < locations.size(); i++) {
+        Location& location = locations[i];
+        if (location.endpoints.isValid()) {
+            if (now < location.retry_after ||
+                now - location.endpoints.resolved_at < static_cast<std::time_t>(endpoint_revalidate_hours_) * 60 * 60) {
+                continue;
+            }
+            // Inline rather than in the background: refresh() already runs
+            // off the render thread, and the old endpoints stay in use on failure
+            std::cout << "Revalidating NWS endpoints for " << location.name << std::endl;
+        } else {
+            if (endpoint_cache_) {
+                auto cached = endpoint_cache_->load(location.latitude, location.longitude);
+                if (cached.has_value()) {
+                    location.endpoints = cached.value();
+                    location.stations->reset(location.endpoints.stations);
+                    continue;
+                }
+            }
+            std::cout << "Fetching NWS endpoints for " << location.name << "..." << std::endl;
+        }
+        
+        ResolvedEndpoints& endpoints = resolving[i];
+        endpoints.latitude = location.latitude;
+        endpoints.longitude = location.longitude;
+        endpoints.points = client_->getPoints(location.latitude, location.longitude);
+        if (!endpoints.points.valid) {
+            std::cerr << "Failed to get NWS points for " << location.name << ": "
+                      << client_->getLastError() << std::endl;
+            location.retry_after = now + ENDPOINT_RETRY_SECONDS;
+            resolving.erase(i);
+            continue;
+        }
+        pending_stations[endpoints.points.stations_url].push_back(i);
+    }
+    
+    // Neighbouring locations share a station list; fetch it once, unranked,
+    // and rank it for each of them locally
+    for (const auto& entry : pending_stations) {
+        const Location& first = locations[entry.second.front()];
+        std::vector<NWSStation> stations = client_->getStations(entry.first, first.latitude, first.longitude);
+        if (stations.empty()) {
+            std::cerr << "No weather stations found at " << entry.first << std::endl;
+            for (size_t index : entry.second) {
+                locations[index].retry_after = now + ENDPOINT_RETRY_SECONDS;
+            }
+            continue;
+        }
+        
+        for (size_t index : entry.second) {
+            Location& location = locations[index];
+            ResolvedEndpoints& endpoints = resolving[index];
+            endpoints.stations = rankStations(stations, location.latitude, location.longitude);
+            endpoints.resolved_at = std::time(nullptr);
+            if (location.endpoints.isValid() &&
+                (endpoints.points.forecast_grid_url != location.endpoints.points.forecast_grid_url ||
+                 endpoints.stations[0].id != location.endpoints.stations[0].id)) {
+                std::cout << "NWS endpoints for " << location.name << " changed on revalidation" << std::endl;
+            }
+            location.endpoints = endpoints;
+            location.retry_after = 0;
+            location.stations->reset(location.endpoints.stations);
+            if (endpoint_cache_) {
+                endpoint_cache_->store(location.endpoints);
+            }
+        }
+    }
+}
+
+bool MultiLocationService::refresh() {
+    std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+    
+    std::vector<Location> locations;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        locations = locations_;
+    }
+    
+    uint64_t requests_before = client_->getTransferStats().requests;
+    
+    resolveLocations(locations);
+    
+    auto now = std::chrono::steady_clock::now();
+    std::time_t wall_now = std::time(nullptr);
+    // Fetches are waited on until this deadline; observation failover stops at it too
+    auto deadline = now + std::chrono::seconds(fetch_timeout_seconds_);
+    size_t reused = 0;
+    
+    // Group locations by grid and by nearest station
+    std::map<std::string, GridFetch> grids;
+    // Keyed by primary station; locations sharing one share its failover too
+    std::map<std::string, std::future<NWSObservation>> observation_futures;
+    std::set<std::string> stations_used;
+    auto client = client_;
+    for (const auto& location : locations) {
+        if (!location.endpoints.isValid()) {
+            continue;
+        }
+        const NWSPoints& points = location.endpoints.points;
+        GridFetch& grid = grids[gridKey(points)];
+        if (grid.grid_url.empty()) {
+            grid.grid_url = points.forecast_grid_url;
+            grid.forecast_url = points.forecast_url;
+            grid.hourly_url = points.forecast_hourly_url;
+        }
+        const std::string& station_id = location.endpoints.stations[0].id;
+        if (!stations_used.insert(station_id).second) {
+            continue;
+        }
+        auto held = held_observations_.find(station_id);
+        if (held != held_observations_.end() &&
+            !isSourceDue(held->second.fetched_at, held->second.data_time, freshness_.observation_ttl, now, wall_now)) {
+            reused++;
+            continue;
+        }
+        auto station_index = location.stations;
+        observation_futures[station_id] = runDetached([client, station_index, deadline]() {
+            return fetchObservationWithFailover(*client, *station_index, nullptr, deadline);
+        });
+    }
+    
+    // One gridpoint series (and hourly forecast) per unique grid that is due, all concurrent
+    for (auto& entry : grids) {
+        GridFetch& grid = entry.second;
+        const HeldGrid& held = held_grids_[entry.first];
+        if (!held.series || isSourceDue(held.fetched_at, static_cast<std::time_t>(held.series->update_time),
+                                        freshness_.gridpoint_ttl, now, wall_now)) {
+            std::string grid_url = grid.grid_url;
+            grid.series = runDetached([client, grid_url]() {
+                return client->getGridpointSeries(grid_url);
+            });
+        } else {
+            reused++;
+        }
+        if (hourly_forecast_enabled_ && !grid.hourly_url.empty()) {
+            if (!held.hourly || isSourceDue(held.hourly_fetched_at, 0, freshness_.hourly_ttl, now, wall_now)) {
+                std::string hourly_url = grid.hourly_url;
+                grid.hourly = runDetached([client, hourly_url]() {
+                    return client->getHourlyForecast(hourly_url);
+                });
+            } else {
+                reused++;
+            }
+        }
+    }
+    
+    // Stations whose due fetch failed; their locations show the held reading as stale
+    std::set<std::string> failed_stations;
+    for (auto& entry : observation_futures) {
+        NWSObservation obs = waitUntil(entry.second, deadline);
+        if (!obs.valid) {
+            std::cout << "Warning: Could not get observations for " << entry.first << std::endl;
+            failed_stations.insert(entry.first);
+            continue;
+        }
+        HeldObservation& held = held_observations_[entry.first];
+        int64_t observed = 0;
+        held.data_time = parseIsoTimestamp(obs.timestamp, observed) ? static_cast<std::time_t>(observed) : 0;
+        held.fetched_at = now;
+        held.observation = obs;
+    }
+    
+    // Fall back to the icon forecast only for grids with no gridpoint
+    // series at all, rather than speculatively for every grid
+    for (auto& entry : grids) {
+        GridFetch& grid = entry.second;
+        HeldGrid& held = held_grids_[entry.first];
+        if (grid.series.valid()) {
+            auto series = waitUntil(grid.series, deadline);
+            if (series) {
+                held.series = series;
+                held.fetched_at = now;
+            } else {
+                grid.failed = true;
+            }
+        }
+        if (held.series) {
+            continue;
+        }
+        if (held.icon_forecast.valid &&
+            !isSourceDue(held.icon_fetched_at, 0, freshness_.forecast_ttl, now, wall_now)) {
+            reused++;
+            continue;
+        }
+        std::string forecast_url = grid.forecast_url;
+        grid.icon = runDetached([client, forecast_url]() {
+            return client->getForecastWithIcon(forecast_url);
+        });
+    }
+    for (auto& entry : grids) {
+        GridFetch& grid = entry.second;
+        HeldGrid& held = held_grids_[entry.first];
+        if (grid.icon.valid()) {
+            NWSForecast forecast = waitUntil(grid.icon, deadline);
+            if (forecast.valid) {
+                held.icon_forecast = forecast;
+                held.icon_fetched_at = now;
+                grid.failed = false;
+            } else {
+                grid.failed = true;
+            }
+        }
+        if (grid.hourly.valid()) {
+            auto hourly = waitUntil(grid.hourly, deadline);
+            if (hourly) {
+                held.hourly = hourly;
+                held.hourly_fetched_at = now;
+            }
+        }
+    }
+    
+    // Fan the held results out to every location
+    std::vector<WeatherData> results(locations.size());
+    bool any_valid = false;
+    for (size_t i = 0; i < locations.size(); i++) {
+        const Location& location = locations[i];
+        WeatherData& data = results[i];
+        if (!location.endpoints.isValid()) {
+            data.error_message = "Failed to resolve NWS endpoints for " + location.name;
+            continue;
+        }
+        
+        const std::string& station_id = location.endpoints.stations[0].id;
+        const std::string key = gridKey(location.endpoints.points);
+        const HeldGrid& held = held_grids_[key];
+        auto held_obs = held_observations_.find(station_id);
+        NWSObservation obs = held_obs != held_observations_.end() ? held_obs->second.observation : NWSObservation();
+        NWSForecast grid_forecast = held.series ? held.series->forecastAt(wall_now) : NWSForecast();
+        
+        if (obs.valid) {
+            WeatherService::applyObservation(data, obs);
+        }
+        if (grid_forecast.valid) {
+            WeatherService::applyGridForecast(data, grid_forecast, obs);
+        } else {
+            WeatherService::applyIconForecast(data, held.icon_forecast);
+        }
+        data.hourly = held.hourly;
+        
+        if (obs.valid || grid_forecast.valid || held.icon_forecast.valid) {
+            data.is_valid = true;
+            data.location = location.name;
+            data.timestamp = wall_now;
+            // Held data from a source whose due fetch failed is shown but not current
+            data.is_stale = failed_stations.count(station_id) > 0 || grids[key].failed;
+            any_valid = true;
+        } else {
+            data.error_message = "No valid data received from NWS for " + location.name;
+        }
+    }
+    
+    // Drop held data for grids and stations no location uses any more
+    for (auto it = held_grids_.begin(); it != held_grids_.end();) {
+        it = grids.count(it->first) ? std::next(it) : held_grids_.erase(it);
+    }
+    for (auto it = held_observations_.begin(); it != held_observations_.end();) {
+        it = stations_used.count(it->first) ? std::next(it) : held_observations_.erase(it);
+    }
+    
+    MultiLocationStats stats;
+    stats.locations = locations.size();
+    stats.unique_grids = grids.size();
+    stats.unique_stations = stations_used.size();
+    stats.http_requests = client_->getTransferStats().requests - requests_before;
+    stats.reused = reused;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Locations added during the refresh keep their empty results
+        for (size_t i = 0; i < locations.size(); i++) {
+            locations_[i].endpoints = locations[i].endpoints;
+            locations_[i].retry_after = locations[i].retry_after;
+            const WeatherData& previous = results_[i];
+            // Stale data keeps the time it was last current; an unchanged
+            // reading keeps its timestamp so the display can skip its refresh
+            if (previous.is_valid &&
+                (results[i].is_stale || (!previous.is_stale && sameReading(results[i], previous)))) {
+                results[i].timestamp = previous.timestamp;
+            }
+            results_[i] = results[i];
+        }
+        stats_ = stats;
+        last_error_ = any_valid ? std::string() : "No valid data received from NWS";
+    }
+    
+    if (stats_logging_) {
+        printRefreshStats();
+    }
+    return any_valid;
+}
+
+void MultiLocationService::printRefreshStats() const {
+    MultiLocationStats stats = getStats();
+    std::cout << "Multi-location refresh: " << stats.locations << " locations, "
+              << stats.unique_grids << " grids, "
+              << stats.unique_stations << " stations, "
+              << stats.reused << " reused while fresh, "
+              << stats.http_requests << " HTTP requests" << std::endl;
+    
+    ConnectionStats conn = client_->getConnectionStats();
+    std::cout << "NWS connections: " << conn.connections_opened << " opened, "
+              << conn.connections_reused << " reused, "
+              << conn.reconnects << " reconnects" << std::endl;
+    
+    CacheStats cache = client_->getCacheStats();
+    std::cout << "NWS response cache: " << cache.fresh_hits << " fresh, "
+              << cache.not_modified << " not modified, "
+              << cache.misses << " downloaded" << std::endl;
+}
@@ -0,0 +1,129 @@
+#ifndef MULTI_LOCATION_SERVICE_H
+#define MULTI_LOCATION_SERVICE_H
+
+#include "weather_data.h"
+#include "weather_service.h"
+#include "nws_client.h"
+#include "endpoint_cache.h"
+#include "station_index.h"
+#include <memory>
+#include <mutex>
+#include <map>
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Work done by the last refresh()
+struct MultiLocationStats {
+    size_t locations = 0;
+    size_t unique_grids = 0;        // Distinct office/gridX/gridY among resolved locations
+    size_t unique_stations = 0;     // Distinct nearest stations among resolved locations
+    uint64_t http_requests = 0;     // Requests that reached the server during the refresh
+    size_t reused = 0;              // Grid, station and hourly results still fresh and not refetched
+};
+
+/**
+ * Weather for several locations through one NWSClient, so they share its
+ * connections and response cache. Locations that resolve to the same
+ * forecast grid (office/gridX/gridY) or the same nearest station are
+ * fetched and decoded once and the result is copied to each of them, so
+ * requests per refresh scale with unique grids and stations rather than
+ * with the number of locations. Like WeatherService, each grid, station
+ * and hourly result is reused until its FreshnessPolicy TTL runs out, and
+ * a due source that fails leaves the location's data marked stale.
+ */
+class MultiLocationService {
+public:
+    MultiLocationService();
+    ~MultiLocationService();
+    
+    // Add a location; returns its index for getWeatherData()
+    size_t addLocation(const std::string& name, double latitude, double longitude);
+    size_t locationCount() const;
+    std::string locationName(size_t index) const;
+    
+    // Resolve any new locations and fetch every unique grid and station
+    // whose data is due. Returns true if at least one location has valid data.
+    bool refresh();
+    
+    // Data from the last refresh for a location; invalid if out of range
+    WeatherData getWeatherData(size_t index) const;
+    
+    // Configuration
+    void setFetchTimeout(int seconds) { fetch_timeout_seconds_ = seconds; }
+    void setUserAgent(const std::string& user_agent) { client_->setUserAgent(user_agent); }
+    void setBaseUrl(const std::string& base_url) { client_->setBaseUrl(base_url); }
+    void setTransport(std::unique_ptr<HttpTransport> transport) { client_->setTransport(std::move(transport)); }
+    void setCompression(bool enabled) { client_->setCompression(enabled); }
+    void setTransferLogging(bool enabled) { client_->setTransferLogging(enabled); }
+    void setMaxResponseBytes(size_t max_bytes) { client_->setMaxResponseBytes(max_bytes); }
+    void setHourlyForecast(bool enabled) { hourly_forecast_enabled_ = enabled; }
+    void setFreshnessPolicy(const FreshnessPolicy& policy) { freshness_ = policy; }
+    // Print the refresh counters after each refresh
+    void setStatsLogging(bool enabled) { stats_logging_ = enabled; }
+    
+    // Same file format as WeatherService; an empty path disables the file
+    void setEndpointCacheFile(const std::string& path);
+    // Endpoints older than this are resolved again during a refresh
+    void setEndpointRevalidateInterval(int hours) { endpoint_revalidate_hours_ = hours; }
+    
+    std::string getLastError() const;
+    MultiLocationStats getStats() const;
+    ConnectionStats getConnectionStats() const { return client_->getConnectionStats(); }
+    CacheStats getCacheStats() const { return client_->getCacheStats(); }
+    
+private:
+    struct Location {
+        std::string name;
+        double latitude;
+        double longitude;
+        ResolvedEndpoints endpoints;  // Valid once resolved
+        std::shared_ptr<StationIndex> stations;  // Ranking and health for failover
+        std::time_t retry_after = 0;  // Earliest retry after a failed revalidation
+    };
+    
+    // Latest result of each shared source, reused until it is due
+    struct HeldObservation {
+        NWSObservation observation;
+        std::chrono::steady_clock::time_point fetched_at;
+        std::time_t data_time = 0;
+    };
+    struct HeldGrid {
+        std::shared_ptr<const GridpointSeries> series;
+        std::chrono::steady_clock::time_point fetched_at;
+        NWSForecast icon_forecast;    // Only fetched while no series is held
+        std::chrono::steady_clock::time_point icon_fetched_at;
+        std::shared_ptr<const HourlyForecast> hourly;
+        std::chrono::steady_clock::time_point hourly_fetched_at;
+    };
+    
+    // Run /points for unresolved locations and those due for revalidation,
+    // then one stations request per distinct stations URL, ranked locally
+    // for each location
+    void resolveLocations(std::vector<Location>& locations);
+    void printRefreshStats() const;
+    
+    // Shared so that fetches still running after a timeout keep the client alive
+    std::shared_ptr<NWSClient> client_;
+    std::shared_ptr<EndpointCache> endpoint_cache_;
+    int fetch_timeout_seconds_;
+    bool hourly_forecast_enabled_;
+    bool stats_logging_;
+    int endpoint_revalidate_hours_;
+    FreshnessPolicy freshness_;
+    
+    // Serialises refresh() so locations_ is only modified by one caller
+    std::mutex refresh_mutex_;
+    // Only touched by refresh(), under refresh_mutex_
+    std::map<std::string, HeldObservation> held_observations_;  // By primary station
+    std::map<std::string, HeldGrid> held_grids_;                 // By grid key
+    
+    mutable std::mutex mutex_;  // Guards everything below
+    std::vector<Location> locations_;
+    std::vector<WeatherData> results_;
+    MultiLocationStats stats_;
+    std::string last_error_;
+};
+
+#endif // MULTI_LOCATION_SERVICE_H
@@ -1,15 +1,65 @@
 #include "nws_client.h"
-#include <httplib.h>
+#include "content_decoder.h"
+#include "nws_decoders.h"
+#include "station_index.h"
+#include "body_stream.h"
+#include "weather_condition.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
 #include <algorithm>
+#include <map>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+// Result of decoding one observation response
+struct ObservationWindow {
+    NWSObservation observation;
+    int feature_count = 0;
+    bool complete = false;  // Every feature was examined
+    bool unchanged = false; // Stopped at the reading already held
+};
+
+// limit= windows tried, smallest first, when the latest reading fails QC.
+// 500 is the API maximum and what the unbounded query returns.
+constexpr int OBSERVATION_WINDOWS[] = {8, 32, 128, 500};
+constexpr size_t OBSERVATION_WINDOW_COUNT = sizeof(OBSERVATION_WINDOWS) / sizeof(OBSERVATION_WINDOWS[0]);
+constexpr int FULL_HISTORY_FEATURES = 500;
+
+// Reduce an absolute URL from a response to its path, whatever the host,
+// so links keep working when the client talks to a different server
+std::string toPath(const std::string& url) {
+    size_t scheme = url.find("://");
+    if (scheme == std::string::npos) {
+        return url;
+    }
+    size_t path = url.find('/', scheme + 3);
+    return path == std::string::npos ? "/" : url.substr(path);
+}
+
+} // namespace
 
 NWSClient::NWSClient() 
     : user_agent_("rpi0-weather/1.0")
+    , base_url_(NWS_BASE_URL)
     , timeout_seconds_(10)
+    , compression_enabled_(false)
+    , transfer_logging_(false)
+    , max_response_bytes_(DEFAULT_MAX_RESPONSE_BYTES)
+    , transport_(std::make_unique<LiveTransport>(base_url_))
+    , transfer_requests_(0)
+    , wire_bytes_(0)
+    , decoded_bytes_(0)
+    , observation_queries_(0)
+    , observation_latest_hits_(0)
+    , observation_fallbacks_(0)
+    , observation_widenings_(0)
+    , observation_unchanged_(0)
+    , observation_bytes_saved_(0)
 {
 }
 
@@ -22,328 +72,562 @@ void NWSClient::setUserAgent(const std::string& user_agent) {
 
 void NWSClient::setTimeout(int timeout_seconds) {
     timeout_seconds_ = timeout_seconds;
+    transport_->setTimeout(timeout_seconds);
 }
 
-std::optional<nlohmann::json> NWSClient::fetchJSON(const std::string& url) {
-    try {
-        httplib::Client client(std::string("https://") + NWS_BASE_URL);
-        client.set_connection_timeout(timeout_seconds_);
-        client.set_read_timeout(timeout_seconds_);
-        client.set_follow_location(true);
-        
-        httplib::Headers headers = {
-            {"User-Agent", user_agent_},
-            {"Accept", "application/json"}
-        };
-        
-        auto res = client.Get(url.c_str(), headers);
-        
-        if (!res) {
-            last_error_ = "Network request failed";
-            return std::nullopt;
-        }
-        
-        if (res->status != 200) {
-            last_error_ = "HTTP " + std::to_string(res->status) + ": " + res->reason;
-            return std::nullopt;
-        }
-        
-        return nlohmann::json::parse(res->body);
-        
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Exception: ") + e.what();
-        return std::nullopt;
+void NWSClient::setBaseUrl(const std::string& base_url) {
+    base_url_ = base_url.empty() ? std::string(NWS_BASE_URL) : base_url;
+    while (base_url_.size() > 1 && base_url_.back() == '/') {
+        base_url_.pop_back();
     }
+    setTransport(std::make_unique<LiveTransport>(base_url_));
 }
 
-NWSPoints NWSClient::getPoints(double latitude, double longitude) {
-    NWSPoints result;
-    
-    std::stringstream url;
-    url << "/points/" << std::fixed << std::setprecision(4) << latitude << "," << longitude;
-    
-    auto json_opt = fetchJSON(url.str());
-    if (!json_opt.has_value()) {
-        return result;
+void NWSClient::setTransport(std::unique_ptr<HttpTransport> transport) {
+    transport_ = std::move(transport);
+    transport_->setTimeout(timeout_seconds_);
+    cache_.clear();
+}
+
+void NWSClient::setCompression(bool enabled) {
+    if (enabled && !ContentDecoder::isCompressionSupported()) {
+        std::cerr << "Warning: built without zlib, compressed transfer disabled" << std::endl;
+        enabled = false;
+    }
+    compression_enabled_ = enabled;
+}
+
+TransferStats NWSClient::getTransferStats() const {
+    TransferStats stats;
+    stats.requests = transfer_requests_;
+    stats.wire_bytes = wire_bytes_;
+    stats.decoded_bytes = decoded_bytes_;
+    return stats;
+}
+
+ObservationQueryStats NWSClient::getObservationQueryStats() const {
+    ObservationQueryStats stats;
+    stats.queries = observation_queries_;
+    stats.latest_hits = observation_latest_hits_;
+    stats.fallbacks = observation_fallbacks_;
+    stats.widenings = observation_widenings_;
+    stats.unchanged = observation_unchanged_;
+    stats.bytes_saved = observation_bytes_saved_;
+    return stats;
+}
+
+std::string NWSClient::getLastError() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+void NWSClient::setLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = error;
+}
+
+bool NWSClient::performGet(const std::string& url,
+                           const std::vector<std::pair<std::string, std::string>>& extra_headers,
+                           const std::atomic<bool>* cancel, StreamingParse* parse, RawResponse& response) {
+    HttpTransport::Headers headers = {
+        {"User-Agent", user_agent_},
+        {"Accept", "application/json"}
+    };
+    if (compression_enabled_) {
+        headers.emplace_back("Accept-Encoding", ContentDecoder::acceptEncoding());
     }
+    headers.insert(headers.end(), extra_headers.begin(), extra_headers.end());
     
-    try {
-        const auto& json = json_opt.value();
-        const auto& props = json["properties"];
-        
-        result.valid = true;
-        result.forecast_grid_url = props["forecastGridData"].get<std::string>();
-        result.stations_url = props["observationStations"].get<std::string>();
-        result.forecast_url = props["forecast"].get<std::string>();
-        result.forecast_hourly_url = props["forecastHourly"].get<std::string>();
-        result.office_id = props["gridId"].get<std::string>();
-        result.grid_x = props["gridX"].get<int>();
-        result.grid_y = props["gridY"].get<int>();
-        
-        // Convert full URLs to paths
-        std::string base = "https://api.weather.gov";
-        if (result.forecast_grid_url.find(base) == 0) {
-            result.forecast_grid_url = result.forecast_grid_url.substr(base.length());
+    std::unique_ptr<ContentDecoder> decoder;
+    std::string content_encoding;
+    uint64_t wire_bytes = 0;
+    uint64_t decoded_bytes = 0;
+    bool decode_failed = false;
+    BodyStream* sink = nullptr;
+    const uint64_t max_bytes = max_response_bytes_;
+    
+    auto on_response = [&](const TransportResponse& res) {
+        content_encoding = res.header("Content-Encoding");
+        decoder = std::make_unique<ContentDecoder>(ContentDecoder::parseEncoding(content_encoding));
+        wire_bytes = 0;
+        decoded_bytes = 0;
+        if (decoder->encoding() == ContentDecoder::Encoding::Unsupported) {
+            return false;
         }
-        if (result.stations_url.find(base) == 0) {
-            result.stations_url = result.stations_url.substr(base.length());
+        
+        // Refuse a declared oversized body before reading any of it
+        std::string content_length = res.header("Content-Length");
+        if (!content_length.empty() && std::strtoull(content_length.c_str(), nullptr, 10) > max_bytes) {
+            response.too_large = true;
+            return false;
         }
-        if (result.forecast_url.find(base) == 0) {
-            result.forecast_url = result.forecast_url.substr(base.length());
+        
+        // Only a 200 body is parsed; others are counted and dropped
+        sink = (parse != nullptr && res.status == 200) ? parse->start() : nullptr;
+        return true;
+    };
+    
+    // Wire bytes are decoded and handed to the parser as they arrive;
+    // returning false aborts the transfer
+    auto on_content = [&](const char* data, size_t length) {
+        if (cancel != nullptr && cancel->load()) {
+            return false;
         }
-        if (result.forecast_hourly_url.find(base) == 0) {
-            result.forecast_hourly_url = result.forecast_hourly_url.substr(base.length());
+        wire_bytes += length;
+        bool ok = decoder->decode(data, length, [&](const char* decoded, size_t decoded_length) {
+            decoded_bytes += decoded_length;
+            // Checked after decoding, so a small compressed body that
+            // inflates past the limit is caught too
+            if (decoded_bytes > max_bytes) {
+                response.too_large = true;
+                return false;
+            }
+            if (sink != nullptr) {
+                sink->write(decoded, decoded_length);
+            }
+            return true;
+        });
+        decode_failed = !ok && !response.too_large;
+        return ok;
+    };
+    
+    TransportResponse res;
+    std::string transport_error;
+    bool received = transport_->get(url, headers, on_response, on_content, res, transport_error);
+    if (sink != nullptr) {
+        sink->close();
+    }
+    if (!received) {
+        if (response.too_large) {
+            setLastError("Response for " + url + " exceeds " + std::to_string(max_bytes) + " bytes");
+        } else if (decode_failed) {
+            setLastError("Failed to decode " + std::string(decoder->encodingName()) + " response");
+        } else if (decoder && decoder->encoding() == ContentDecoder::Encoding::Unsupported) {
+            setLastError("Unsupported Content-Encoding: " + content_encoding);
+        } else {
+            setLastError("Network request failed: " + transport_error);
         }
-        
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Failed to parse points data: ") + e.what();
-        result.valid = false;
+        return false;
     }
     
-    return result;
-}
-
-std::vector<NWSStation> NWSClient::getStations(const std::string& stations_url, double lat, double lon) {
-    std::vector<NWSStation> stations;
+    response.status = res.status;
+    response.reason = res.reason;
+    response.cache_headers.etag = res.header("ETag");
+    response.cache_headers.last_modified = res.header("Last-Modified");
+    response.cache_headers.cache_control = res.header("Cache-Control");
+    response.cache_headers.expires = res.header("Expires");
+    response.cache_headers.date = res.header("Date");
+    response.cache_headers.age = res.header("Age");
     
-    auto json_opt = fetchJSON(stations_url);
-    if (!json_opt.has_value()) {
-        return stations;
-    }
+    response.wire_bytes = wire_bytes;
+    response.decoded_bytes = decoded_bytes;
     
-    try {
-        const auto& json = json_opt.value();
-        const auto& features = json["features"];
-        
-        for (const auto& feature : features) {
-            NWSStation station;
-            const auto& props = feature["properties"];
-            const auto& coords = feature["geometry"]["coordinates"];
-            
-            station.id = props["stationIdentifier"].get<std::string>();
-            station.name = props["name"].get<std::string>();
-            station.longitude = coords[0].get<double>();
-            station.latitude = coords[1].get<double>();
-            
-            // Calculate distance squared (avoiding sqrt for efficiency)
-            double dlat = lat - station.latitude;
-            double dlon = lon - station.longitude;
-            station.distance_squared = dlat * dlat + dlon * dlon;
-            
-            stations.push_back(station);
-        }
-        
-        // Sort by distance
-        std::sort(stations.begin(), stations.end(), 
-                  [](const NWSStation& a, const NWSStation& b) {
-                      return a.distance_squared < b.distance_squared;
-                  });
-        
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Failed to parse stations data: ") + e.what();
+    transfer_requests_++;
+    wire_bytes_ += wire_bytes;
+    decoded_bytes_ += decoded_bytes;
+    
+    if (transfer_logging_) {
+        std::cout << "GET " << url << " -> " << response.status << " "
+                  << (decoder ? decoder->encodingName() : "identity") << " "
+                  << wire_bytes << " bytes on wire, "
+                  << decoded_bytes << " bytes decoded" << std::endl;
     }
     
-    return stations;
+    return true;
 }
 
-NWSObservation NWSClient::getLatestObservation(const std::string& station_id) {
-    NWSObservation result;
-    
-    std::string url = "/stations/" + station_id + "/observations";
-    auto json_opt = fetchJSON(url);
-    if (!json_opt.has_value()) {
-        return result;
+template <typename T, typename Decode>
+std::shared_ptr<const T> NWSClient::fetchDecoded(const std::string& url, Decode decode,
+                                                 const std::atomic<bool>* cancel,
+                                                 FetchInfo* info,
+                                                 std::chrono::steady_clock::time_point deadline) {
+    FetchInfo local_info;
+    if (info == nullptr) {
+        info = &local_info;
     }
     
     try {
-        const auto& json = json_opt.value();
-        const auto& features = json["features"];
+        // Serve straight from the cache while the response is still fresh
+        auto cached = cache_.lookup(url);
+        if (cached.has_value() && cached->isFresh(ResponseCache::Clock::now())) {
+            cache_.recordFreshHit();
+            info->status = 200;
+            return std::any_cast<std::shared_ptr<const T>>(cached->decoded);
+        }
         
-        // Find first valid temperature reading
-        for (const auto& feature : features) {
-            const auto& props = feature["properties"];
-            
-            // Check if temperature has valid quality control
-            if (props.contains("temperature") && 
-                props["temperature"].contains("qualityControl") &&
-                props["temperature"]["qualityControl"] == "V") {
-                
-                result.valid = true;
-                result.timestamp = props["timestamp"].get<std::string>();
-                
-                if (props["temperature"].contains("value") && !props["temperature"]["value"].is_null()) {
-                    result.temperature_celsius = props["temperature"]["value"].get<double>();
-                }
-                
-                if (props.contains("dewpoint") && props["dewpoint"].contains("value") && !props["dewpoint"]["value"].is_null()) {
-                    result.dewpoint_celsius = props["dewpoint"]["value"].get<double>();
-                }
-                
-                if (props.contains("windSpeed") && props["windSpeed"].contains("value") && !props["windSpeed"]["value"].is_null()) {
-                    result.wind_speed_kmh = props["windSpeed"]["value"].get<double>();
-                }
-                
-                if (props.contains("windDirection") && props["windDirection"].contains("value") && !props["windDirection"]["value"].is_null()) {
-                    result.wind_direction_degrees = props["windDirection"]["value"].get<int>();
+        EndpointClass endpoint = classifyEndpoint(url);
+        retry_.recordRequest(endpoint);
+        
+        // Anything cached beats waiting on a request that is likely to fail
+        auto serveStale = [&]() -> std::shared_ptr<const T> {
+            if (!cached.has_value()) {
+                return nullptr;
+            }
+            retry_.recordStaleServed(endpoint);
+            info->status = 200;
+            info->downloaded = false;
+            info->served_stale = true;
+            return std::any_cast<std::shared_ptr<const T>>(cached->decoded);
+        };
+        
+        bool probe = false;
+        if (!retry_.allowRequest(endpoint, &probe)) {
+            retry_.recordShortCircuit(endpoint);
+            setLastError(std::string("Circuit open for ") + endpointClassName(endpoint) + " endpoint");
+            return serveStale();
+        }
+        ProbeGuard probe_guard(retry_, endpoint, probe);
+        
+        // Stale entry: ask the server whether our copy is still current
+        std::vector<std::pair<std::string, std::string>> conditional_headers;
+        if (cached.has_value()) {
+            if (!cached->etag.empty()) {
+                conditional_headers.emplace_back("If-None-Match", cached->etag);
+            }
+            if (!cached->last_modified.empty()) {
+                conditional_headers.emplace_back("If-Modified-Since", cached->last_modified);
+            }
+        }
+        
+        // The caller's deadline can be tighter than the endpoint's budget
+        RetryPolicy policy = retry_.policy(endpoint);
+        deadline = std::min(deadline, std::chrono::steady_clock::now() + policy.budget);
+        
+        // A 200 body is decoded on a parser thread while it downloads
+        std::shared_ptr<T> result;
+        StreamingParse parse([&](std::istream& body, std::string& error) {
+            result = std::make_shared<T>();
+            return decode(body, *result, error);
+        });
+        
+        RawResponse res;
+        for (int attempt = 1; ; attempt++) {
+            res = RawResponse();
+            bool transient;
+            if (!performGet(url, conditional_headers, cancel, &parse, res)) {
+                if (cancel != nullptr && cancel->load()) {
+                    return nullptr;
                 }
-                
-                if (props.contains("relativeHumidity") && props["relativeHumidity"].contains("value") && !props["relativeHumidity"]["value"].is_null()) {
-                    result.humidity_percent = props["relativeHumidity"]["value"].get<double>();
+                if (res.too_large) {
+                    // Would be just as large next time
+                    return serveStale();
                 }
-                
-                if (props.contains("barometricPressure") && props["barometricPressure"].contains("value") && !props["barometricPressure"]["value"].is_null()) {
-                    result.pressure_pa = props["barometricPressure"]["value"].get<double>();
+                transient = true;
+            } else {
+                // Rate limiting and server errors are worth another try
+                transient = res.status == 429 || res.status >= 500;
+                if (transient) {
+                    setLastError("HTTP " + std::to_string(res.status) + ": " + res.reason);
                 }
-                
-                if (props.contains("textDescription") && !props["textDescription"].is_null()) {
-                    result.text_description = props["textDescription"].get<std::string>();
+            }
+            
+            if (!transient) {
+                break;
+            }
+            
+            auto delay = retry_.backoff(endpoint, attempt);
+            if (attempt >= policy.max_attempts ||
+                std::chrono::steady_clock::now() + delay >= deadline) {
+                retry_.recordFailure(endpoint);
+                probe_guard.settle();
+                return serveStale();
+            }
+            
+            retry_.recordRetry(endpoint);
+            std::cout << "Retrying " << url << " in " << delay.count() << " ms (attempt "
+                      << attempt + 1 << " of " << policy.max_attempts << "): "
+                      << getLastError() << std::endl;
+            
+            // Sleep in short steps so a cancelled fetch does not linger
+            auto wake = std::chrono::steady_clock::now() + delay;
+            while (std::chrono::steady_clock::now() < wake) {
+                if (cancel != nullptr && cancel->load()) {
+                    return nullptr;
                 }
-                
-                break; // Found valid observation
+                auto step = std::min<std::chrono::steady_clock::duration>(
+                    wake - std::chrono::steady_clock::now(), std::chrono::milliseconds(100));
+                std::this_thread::sleep_for(step);
             }
         }
         
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Failed to parse observation data: ") + e.what();
-        result.valid = false;
-    }
-    
-    return result;
-}
-
-std::optional<double> NWSClient::getValueAtTime(const nlohmann::json& data, const std::string& field) {
-    try {
-        if (!data.contains(field) || !data[field].contains("values")) {
-            return std::nullopt;
+        // The server answered; whatever the status, the endpoint is up
+        retry_.recordSuccess(endpoint);
+        probe_guard.settle();
+        info->status = res.status;
+        info->downloaded = true;
+        info->wire_bytes = res.wire_bytes;
+        
+        if (res.status == 304 && cached.has_value()) {
+            cache_.recordNotModified();
+            cache_.revalidate(url, res.cache_headers);
+            return std::any_cast<std::shared_ptr<const T>>(cached->decoded);
         }
         
-        const auto& values = data[field]["values"];
-        if (values.empty()) {
-            return std::nullopt;
+        if (res.status != 200) {
+            setLastError("HTTP " + std::to_string(res.status) + ": " + res.reason);
+            return nullptr;
         }
         
-        // For now, just return the first value
-        // In a more sophisticated implementation, we'd parse the validTime
-        // and find the value closest to current time
-        if (values[0].contains("value") && !values[0]["value"].is_null()) {
-            return values[0]["value"].get<double>();
+        cache_.recordMiss();
+        std::string error;
+        if (!parse.finish(error)) {
+            setLastError(error);
+            return nullptr;
         }
         
+        std::shared_ptr<const T> decoded = std::move(result);
+        cache_.store(url, res.cache_headers, decoded);
+        return decoded;
+        
     } catch (const std::exception& e) {
-        // Silently fail for individual field parsing
+        setLastError(std::string("Exception: ") + e.what());
+        return nullptr;
     }
+}
+
+NWSPoints NWSClient::getPoints(double latitude, double longitude) {
+    std::stringstream url;
+    url << "/points/" << std::fixed << std::setprecision(4) << latitude << "," << longitude;
+    
+    auto points = fetchDecoded<NWSPoints>(url.str(),
+        [](std::istream& body, NWSPoints& out, std::string& error) {
+            PointsDecoder decoder;
+            if (!decoder.parse(body)) {
+                error = "Failed to parse points data: " + decoder.error();
+                return false;
+            }
+            if (decoder.points.forecast_grid_url.empty() || decoder.points.stations_url.empty() ||
+                decoder.points.forecast_url.empty() || decoder.points.office_id.empty()) {
+                error = "Failed to parse points data: missing endpoint URLs";
+                return false;
+            }
+            out = decoder.points;
+            out.valid = true;
+            
+            // Convert full URLs to paths
+            for (std::string* path : {&out.forecast_grid_url, &out.stations_url,
+                                      &out.forecast_url, &out.forecast_hourly_url}) {
+                *path = toPath(*path);
+            }
+            return true;
+        });
     
-    return std::nullopt;
+    return points ? *points : NWSPoints();
 }
 
-NWSForecast NWSClient::getForecast(const std::string& forecast_grid_url) {
-    NWSForecast result;
+std::vector<NWSStation> NWSClient::getStations(const std::string& stations_url, double lat, double lon,
+                                               size_t max_stations) {
+    using StationList = std::vector<NWSStation>;
     
-    auto json_opt = fetchJSON(forecast_grid_url);
-    if (!json_opt.has_value()) {
-        return result;
+    auto decoded = fetchDecoded<StationList>(stations_url,
+        [](std::istream& body, StationList& out, std::string& error) {
+            StationsDecoder decoder;
+            if (!decoder.parse(body)) {
+                error = "Failed to parse stations data: " + decoder.error();
+                return false;
+            }
+            out = std::move(decoder.stations);
+            return true;
+        });
+    
+    if (!decoded) {
+        return {};
     }
     
-    try {
-        const auto& json = json_opt.value();
-        const auto& props = json["properties"];
-        
-        result.valid = true;
-        
-        // Get temperature values
-        result.temperature_max_celsius = getValueAtTime(props, "maxTemperature");
-        result.temperature_min_celsius = getValueAtTime(props, "minTemperature");
-        
-        // Get precipitation chance
-        auto precip = getValueAtTime(props, "probabilityOfPrecipitation");
-        if (precip.has_value()) {
-            result.precipitation_chance_percent = static_cast<int>(precip.value());
-        }
-        
-        // Get sky cover
-        auto sky = getValueAtTime(props, "skyCover");
-        if (sky.has_value()) {
-            result.sky_cover_percent = static_cast<int>(sky.value());
-        }
-        
-        // Get weather conditions
-        if (props.contains("weather") && props["weather"].contains("values")) {
-            const auto& weather_values = props["weather"]["values"];
-            if (!weather_values.empty() && weather_values[0].contains("value")) {
-                const auto& weather_array = weather_values[0]["value"];
-                if (weather_array.is_array() && !weather_array.empty()) {
-                    const auto& weather = weather_array[0];
-                    if (weather.contains("weather") && !weather["weather"].is_null()) {
-                        result.weather_condition = weather["weather"].get<std::string>();
-                    }
-                    if (weather.contains("intensity") && !weather["intensity"].is_null()) {
-                        result.weather_intensity = weather["intensity"].get<std::string>();
-                    }
+    return rankStations(*decoded, lat, lon, max_stations);
+}
+
+NWSObservation NWSClient::getLatestObservation(const std::string& station_id,
+                                               std::chrono::steady_clock::time_point deadline,
+                                               bool* answered,
+                                               const NWSObservation* held) {
+    std::string base_url = "/stations/" + station_id + "/observations";
+    observation_queries_++;
+    
+    bool reached = true;
+    if (answered == nullptr) {
+        answered = &reached;
+    }
+    *answered = true;
+    
+    uint64_t wire_spent = 0;
+    double wire_bytes_per_feature = 0.0;
+    
+    // Fetch one response; decoding stops at the first feature whose
+    // temperature passed QC
+    auto fetchWindow = [&](const std::string& url, ObservationDecoder::Shape shape, FetchInfo& info) {
+        auto window = fetchDecoded<ObservationWindow>(url,
+            [shape, held](std::istream& body, ObservationWindow& out, std::string& error) {
+                ObservationDecoder decoder(shape, held);
+                if (!decoder.parse(body)) {
+                    error = "Failed to parse observation data: " + decoder.error();
+                    return false;
                 }
+                out.observation = decoder.observation;
+                out.feature_count = decoder.feature_count;
+                out.complete = !decoder.stoppedEarly();
+                out.unchanged = decoder.unchanged;
+                return true;
+            }, nullptr, &info, deadline);
+        
+        if (info.status == 0 || info.served_stale) {
+            *answered = false;
+        }
+        if (info.downloaded) {
+            wire_spent += info.wire_bytes;
+            if (window && window->complete && window->feature_count > 0) {
+                wire_bytes_per_feature = static_cast<double>(info.wire_bytes) / window->feature_count;
             }
         }
-        
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Failed to parse forecast data: ") + e.what();
-        result.valid = false;
-    }
+        return window;
+    };
     
-    return result;
-}
-
-NWSForecast NWSClient::getForecastWithIcon(const std::string& forecast_url) {
-    NWSForecast result;
+    NWSObservation result;
     
-    auto json_opt = fetchJSON(forecast_url);
-    if (!json_opt.has_value()) {
+    FetchInfo latest_info;
+    auto latest = fetchWindow(base_url + "/latest", ObservationDecoder::Shape::Single, latest_info);
+    if (latest_info.status == 0) {
+        // Network failure; a wider window would fail the same way
         return result;
     }
     
-    try {
-        const auto& json = json_opt.value();
-        const auto& properties = json["properties"];
-        const auto& periods = properties["periods"];
-        
-        if (periods.empty()) {
-            last_error_ = "No forecast periods found";
-            return result;
+    if (latest && latest->observation.valid) {
+        observation_latest_hits_++;
+        if (latest->unchanged) {
+            observation_unchanged_++;
         }
-        
-        // Get the first period (current/today's forecast)
-        const auto& period = periods[0];
-        
-        result.valid = true;
-        
-        // Extract temperature
-        if (period.contains("temperature") && !period["temperature"].is_null()) {
-            double temp_f = period["temperature"].get<double>();
-            result.temperature_max_celsius = (temp_f - 32.0) * 5.0 / 9.0;  // Convert F to C
-        }
-        
-        // Extract weather icon URL and extract icon name
-        if (period.contains("icon") && !period["icon"].is_null()) {
-            std::string icon_url = period["icon"].get<std::string>();
-            result.weather_icon = extractIconName(icon_url);
+        result = latest->observation;
+    } else {
+        uint64_t fallbacks = ++observation_fallbacks_;
+        if (transfer_logging_) {
+            std::cout << "Observation fallback for " << station_id
+                      << ": latest reading failed QC (" << fallbacks << " of "
+                      << observation_queries_ << " queries)" << std::endl;
         }
         
-        // Extract precipitation probability
-        if (period.contains("probabilityOfPrecipitation") && period["probabilityOfPrecipitation"].contains("value") && !period["probabilityOfPrecipitation"]["value"].is_null()) {
-            result.precipitation_chance_percent = period["probabilityOfPrecipitation"]["value"].get<int>();
+        for (size_t i = 0; i < OBSERVATION_WINDOW_COUNT; i++) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                setLastError("Observation deadline passed for station " + station_id);
+                *answered = false;
+                break;
+            }
+            int limit = OBSERVATION_WINDOWS[i];
+            FetchInfo info;
+            auto window = fetchWindow(base_url + "?limit=" + std::to_string(limit),
+                                      ObservationDecoder::Shape::Collection, info);
+            if (!window) {
+                break;
+            }
+            if (window->observation.valid) {
+                if (window->unchanged) {
+                    observation_unchanged_++;
+                }
+                result = window->observation;
+                break;
+            }
+            
+            // A short window means the station has no more history to offer
+            if (window->feature_count < limit || i + 1 == OBSERVATION_WINDOW_COUNT) {
+                setLastError("No QC-valid observation for station " + station_id);
+                break;
+            }
+            
+            observation_widenings_++;
+            if (transfer_logging_) {
+                std::cout << "Observation fallback for " << station_id << ": no QC-valid reading in "
+                          << limit << " features, widening to " << OBSERVATION_WINDOWS[i + 1] << std::endl;
+            }
         }
-        
-        // Extract detailed forecast and short forecast
-        if (period.contains("detailedForecast") && !period["detailedForecast"].is_null()) {
-            result.weather_condition = period["detailedForecast"].get<std::string>();
+    }
+    
+    // Compare against downloading the unbounded history, as before
+    if (wire_spent > 0 && wire_bytes_per_feature > 0.0) {
+        double full_history = wire_bytes_per_feature * FULL_HISTORY_FEATURES;
+        uint64_t saved = full_history > wire_spent ? static_cast<uint64_t>(full_history) - wire_spent : 0;
+        observation_bytes_saved_ += saved;
+        
+        if (transfer_logging_) {
+            std::cout << "Observation for " << station_id << ": " << wire_spent
+                      << " bytes on wire, ~" << saved << " bytes saved vs. full history" << std::endl;
         }
-        
-    } catch (const std::exception& e) {
-        last_error_ = std::string("Failed to parse forecast with icon data: ") + e.what();
-        result.valid = false;
     }
     
     return result;
 }
 
+std::shared_ptr<const GridpointSeries> NWSClient::getGridpointSeries(const std::string& forecast_grid_url) {
+    return fetchDecoded<GridpointSeries>(forecast_grid_url,
+        [](std::istream& body, GridpointSeries& out, std::string& error) {
+            GridpointDecoder decoder;
+            if (!decoder.parse(body) || !decoder.has_properties) {
+                error = "Failed to parse forecast data: " +
+                        (decoder.error().empty() ? std::string("missing properties") : decoder.error());
+                return false;
+            }
+            out = std::move(decoder.series);
+            out.finalize();
+            return true;
+        });
+}
+
+NWSForecast NWSClient::getForecast(const std::string& forecast_grid_url) {
+    auto series = getGridpointSeries(forecast_grid_url);
+    return series ? series->forecastAt(std::time(nullptr)) : NWSForecast();
+}
+
+std::shared_ptr<const HourlyForecast> NWSClient::getHourlyForecast(const std::string& forecast_hourly_url) {
+    return fetchDecoded<HourlyForecast>(forecast_hourly_url,
+        [this](std::istream& body, HourlyForecast& out, std::string& error) {
+            // Hourly periods repeat a handful of icons; map each URL once
+            std::map<std::string, int> icon_codes;
+            HourlyForecastDecoder decoder([this, &icon_codes](const std::string& icon_url) {
+                auto it = icon_codes.find(icon_url);
+                if (it != icon_codes.end()) {
+                    return it->second;
+                }
+                std::string icon = extractIconName(icon_url);
+                int code = (icon == "na") ? -1 : std::atoi(icon.c_str());
+                icon_codes.emplace(icon_url, code);
+                return code;
+            });
+            
+            if (!decoder.parse(body)) {
+                error = "Failed to parse hourly forecast: " + decoder.error();
+                return false;
+            }
+            if (decoder.hourly.empty()) {
+                error = "No hourly forecast periods found";
+                return false;
+            }
+            out = std::move(decoder.hourly);
+            out.shrinkToFit();
+            return true;
+        });
+}
+
+NWSForecast NWSClient::getForecastWithIcon(const std::string& forecast_url, const std::atomic<bool>* cancel) {
+    auto forecast = fetchDecoded<NWSForecast>(forecast_url,
+        [this](std::istream& body, NWSForecast& out, std::string& error) {
+            ForecastPeriodDecoder decoder;
+            if (!decoder.parse(body)) {
+                error = "Failed to parse forecast with icon data: " + decoder.error();
+                return false;
+            }
+            if (decoder.period_count == 0) {
+                error = "No forecast periods found";
+                return false;
+            }
+            out = decoder.forecast;
+            if (!decoder.icon_url.empty()) {
+                out.weather_icon = extractIconName(decoder.icon_url);
+            }
+            return true;
+        },
+        cancel);
+    
+    return forecast ? *forecast : NWSForecast();
+}
+
 std::string NWSClient::extractIconName(const std::string& icon_url) {
     // NWS icon URLs are like: https://api.weather.gov/icons/land/day/skc?size=medium
     // We want to extract the weather condition part (e.g., "skc")
@@ -361,71 +645,5 @@ std::string NWSClient::extractIconName(const std::string& icon_url) {
     std::string icon_name = url_without_query.substr(last_slash + 1);
     
     // Map NWS icon names to our numbered icon system
-    std::string mapped = mapNWSIconToNumber(icon_name);
-    return mapped;
-}
-
-std::string NWSClient::mapNWSIconToNumber(const std::string& nws_icon) {
-    // Map NWS icon names to our numbered weather icons (00-47)
-    // Based on https://api.weather.gov/icons documentation
-    
-    // Extract base icon name (remove comma and probability if present)
-    std::string base_icon = nws_icon;
-    size_t comma_pos = nws_icon.find(',');
-    if (comma_pos != std::string::npos) {
-        base_icon = nws_icon.substr(0, comma_pos);
-    }
-    
-    // For slight chance conditions, prefer partly cloudy over rain icon
-    // since "slight chance" typically means mostly clear with possibility
-    if (comma_pos != std::string::npos) {
-        std::string probability_str = nws_icon.substr(comma_pos + 1);
-        int probability = 0;
-        try {
-            probability = std::stoi(probability_str);
-        } catch (...) {
-            // Ignore parsing errors
-        }
-        
-        // If probability is 20% or less, use partly cloudy instead of precipitation icon
-        if (probability <= 20) {
-            if (base_icon.find("rain") != std::string::npos || base_icon.find("shwr") != std::string::npos) {
-                return "02";  // Partly Cloudy Day
-            }
-        }
-    }
-    
-    if (base_icon == "skc") return "01";  // Sky Clear -> Clear Day
-    if (base_icon == "few") return "02";  // Few Clouds -> Partly Cloudy Day
-    if (base_icon == "sct") return "02";  // Scattered Clouds -> Partly Cloudy Day
-    if (base_icon == "bkn") return "03";  // Broken Clouds -> Mostly Cloudy
-    if (base_icon == "ovc") return "04";  // Overcast -> Cloudy
-    
-    // Rain conditions
-    if (base_icon == "ra" || base_icon == "rain") return "09";  // Rain -> Rain Day
-    if (base_icon == "shra" || base_icon == "rain_showers") return "09";  // Showers -> Rain Day
-    if (base_icon == "hi_shwrs") return "09";  // Heavy Showers -> Rain Day
-    
-    // Snow conditions
-    if (base_icon == "sn" || base_icon == "snow") return "13";  // Snow -> Snow Day
-    if (base_icon == "mix") return "13";  // Rain/Snow Mix -> Snow Day
-    
-    // Thunderstorm conditions
-    if (base_icon == "tsra") return "17";  // Thunderstorm -> Thunderstorm Day
-    if (base_icon == "hi_tsra") return "17";  // Heavy Thunderstorm -> Thunderstorm Day
-    
-    // Fog/Haze conditions
-    if (base_icon == "fg") return "20";  // Fog -> Fog
-    if (base_icon == "haze") return "20";  // Haze -> Fog
-    
-    // Wind conditions
-    if (base_icon == "wind") return "02";  // Windy -> Partly Cloudy (no specific wind icon)
-    
-    // Default fallback based on common patterns
-    if (base_icon.find("rain") != std::string::npos) return "09";
-    if (base_icon.find("snow") != std::string::npos) return "13";
-    if (base_icon.find("storm") != std::string::npos) return "17";
-    if (base_icon.find("cloud") != std::string::npos) return "03";
-    
-    return "na";  // Unknown condition
+    return iconForNWSSlug(icon_name);
 }
\ No newline at end of file
@@ -4,14 +4,21 @@
 #include <string>
 #include <optional>
 #include <vector>
-#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "http_transport.h"
+#include "response_cache.h"
+#include "retry_policy.h"
 
 struct NWSStation {
     std::string id;
     std::string name;
     double latitude;
     double longitude;
-    double distance_squared;  // Distance squared from target location
+    double distance_km = 0.0;  // Great-circle distance from target location
 };
 
 struct NWSObservation {
@@ -37,6 +44,27 @@ struct NWSForecast {
     std::string weather_icon;  // Icon URL or extracted icon name from NWS API
 };
 
+// Bytes-on-wire versus bytes-decoded, accumulated over all requests
+struct TransferStats {
+    uint64_t requests = 0;
+    uint64_t wire_bytes = 0;
+    uint64_t decoded_bytes = 0;
+};
+
+// How getLatestObservation found its reading
+struct ObservationQueryStats {
+    uint64_t queries = 0;
+    uint64_t latest_hits = 0;       // Satisfied by /observations/latest
+    uint64_t fallbacks = 0;         // Needed a limit= window
+    uint64_t widenings = 0;         // Window grown after no QC-valid feature
+    uint64_t unchanged = 0;         // Parse stopped at the reading already held
+    uint64_t bytes_saved = 0;       // Estimated against the unbounded history
+};
+
+struct GridpointSeries;
+class HourlyForecast;
+class StreamingParse;
+
 struct NWSPoints {
     bool valid = false;
     std::string forecast_grid_url;
@@ -48,6 +76,12 @@ struct NWSPoints {
     int grid_y = 0;
 };
 
+/**
+ * Client for the api.weather.gov endpoints.
+ * Safe to call from several threads at once. Requests go through a
+ * pluggable HttpTransport: live keep-alive connections by default, or a
+ * recording or replaying transport for offline tests.
+ */
 class NWSClient {
 public:
     NWSClient();
@@ -55,27 +89,144 @@ public:
     
     // Main API methods
     NWSPoints getPoints(double latitude, double longitude);
-    std::vector<NWSStation> getStations(const std::string& stations_url, double lat, double lon);
-    NWSObservation getLatestObservation(const std::string& station_id);
+    // Nearest first; only the nearest max_stations are ranked and returned
+    std::vector<NWSStation> getStations(const std::string& stations_url, double lat, double lon,
+                                        size_t max_stations = SIZE_MAX);
+    // Retries and fallback windows stop once deadline passes. answered is
+    // cleared when the station's data could not be reached (network failure,
+    // open breaker, deadline), as opposed to the server replying. With the
+    // reading already held for the station, a response carrying it again
+    // is not parsed past its timestamp.
+    NWSObservation getLatestObservation(const std::string& station_id,
+                                        std::chrono::steady_clock::time_point deadline =
+                                            std::chrono::steady_clock::time_point::max(),
+                                        bool* answered = nullptr,
+                                        const NWSObservation* held = nullptr);
+    // Forecast values in effect now, with today's high/low over the local day
     NWSForecast getForecast(const std::string& forecast_grid_url);
-    NWSForecast getForecastWithIcon(const std::string& forecast_url);  // Get forecast with weather icon
+    // Time-indexed gridpoint series; reused from the cache until the next download
+    std::shared_ptr<const GridpointSeries> getGridpointSeries(const std::string& forecast_grid_url);
+    // Hourly forecast packed into a columnar store; cached until the next download
+    std::shared_ptr<const HourlyForecast> getHourlyForecast(const std::string& forecast_hourly_url);
+    // Get forecast with weather icon; setting *cancel aborts the download early
+    NWSForecast getForecastWithIcon(const std::string& forecast_url, const std::atomic<bool>* cancel = nullptr);
     
     // Utility methods
     void setUserAgent(const std::string& user_agent);
     void setTimeout(int timeout_seconds);
-    std::string getLastError() const { return last_error_; }
+    
+    // Scheme and host requests go to, e.g. a local mock server. Replaces
+    // the transport with a live one, so call it before issuing requests.
+    void setBaseUrl(const std::string& base_url);
+    const std::string& getBaseUrl() const { return base_url_; }
+    
+    // Swap in another transport (record, replay); call before issuing requests
+    void setTransport(std::unique_ptr<HttpTransport> transport);
+    
+    // Opt-in gzip/deflate transfer; ignored if built without zlib
+    void setCompression(bool enabled);
+    bool isCompressionEnabled() const { return compression_enabled_; }
+    
+    // Print wire/decoded sizes for every request
+    void setTransferLogging(bool enabled) { transfer_logging_ = enabled; }
+    
+    std::string getLastError() const;
+    
+    // Keep-alive connection reuse counters
+    ConnectionStats getConnectionStats() const { return transport_->getConnectionStats(); }
+    
+    // Response cache counters (fresh hits, 304 revalidations, full downloads)
+    CacheStats getCacheStats() const { return cache_.getStats(); }
+    
+    // Transfer size counters
+    TransferStats getTransferStats() const;
+    
+    // Bounded observation query counters
+    ObservationQueryStats getObservationQueryStats() const;
+    
+    // Largest decoded response body accepted; larger ones are aborted as
+    // soon as the limit is crossed (or up front from Content-Length)
+    static constexpr size_t DEFAULT_MAX_RESPONSE_BYTES = 4 * 1024 * 1024;
+    void setMaxResponseBytes(size_t max_bytes) { max_response_bytes_ = max_bytes; }
+    size_t getMaxResponseBytes() const { return max_response_bytes_; }
+    
+    // Retry counts and circuit breaker state for each endpoint class
+    std::vector<EndpointRetryStats> getRetryStats() const { return retry_.getStats(); }
+    void setRetryPolicy(EndpointClass endpoint, const RetryPolicy& policy) { retry_.setPolicy(endpoint, policy); }
     
 private:
-    std::optional<nlohmann::json> fetchJSON(const std::string& url);
-    std::optional<double> getValueAtTime(const nlohmann::json& data, const std::string& field);
+    // Status and caching headers of a single GET; the body goes to a
+    // StreamingParse and is never held whole
+    struct RawResponse {
+        int status = 0;
+        std::string reason;
+        ResponseCache::Headers cache_headers;
+        uint64_t wire_bytes = 0;
+        uint64_t decoded_bytes = 0;
+        bool too_large = false;  // Aborted at max_response_bytes_
+    };
+    
+    // What fetchDecoded had to do to produce its result
+    struct FetchInfo {
+        int status = 0;           // HTTP status; 0 on network failure
+        bool downloaded = false;  // False when served fresh from the cache
+        bool served_stale = false; // Stale cache entry returned in place of a reply
+        uint64_t wire_bytes = 0;
+    };
+    
+    // Issue a GET through the transport, decoding any Content-Encoding as
+    // the body streams in and feeding a 200 body to parse as it arrives.
+    // Returns false on a network failure or an oversized body.
+    bool performGet(const std::string& url,
+                    const std::vector<std::pair<std::string, std::string>>& extra_headers,
+                    const std::atomic<bool>* cancel, StreamingParse* parse, RawResponse& response);
+    
+    // Fetch url and stream the body through a decoder producing T; decode
+    // is called as decode(std::istream&, T&, std::string& error) on a
+    // parser thread while the body is still being received. The typed
+    // result is cached and reused while fresh or after a 304 revalidation.
+    // Network failures, 429 and 5xx responses are retried with backoff; once
+    // retries are exhausted or the endpoint's breaker is open, a stale cache
+    // entry is returned if there is one. nullptr on failure.
+    template <typename T, typename Decode>
+    std::shared_ptr<const T> fetchDecoded(const std::string& url, Decode decode,
+                                          const std::atomic<bool>* cancel = nullptr,
+                                          FetchInfo* info = nullptr,
+                                          std::chrono::steady_clock::time_point deadline =
+                                              std::chrono::steady_clock::time_point::max());
+    void setLastError(const std::string& error);
     std::string extractIconName(const std::string& icon_url);  // Extract icon name from NWS icon URL
-    std::string mapNWSIconToNumber(const std::string& nws_icon);  // Map NWS icon names to numbered icons
     
     std::string user_agent_;
+    std::string base_url_;
     int timeout_seconds_;
+    std::atomic<bool> compression_enabled_;
+    std::atomic<bool> transfer_logging_;
+    std::atomic<size_t> max_response_bytes_;
     std::string last_error_;
+    mutable std::mutex error_mutex_;
+    
+    // Live connections, or a recording/replaying stand-in
+    std::unique_ptr<HttpTransport> transport_;
+    
+    // Decoded responses with their validators, keyed by URL path
+    ResponseCache cache_;
+    
+    // Retry budgets and circuit breakers per endpoint class
+    RetryController retry_;
+    
+    std::atomic<uint64_t> transfer_requests_;
+    std::atomic<uint64_t> wire_bytes_;
+    std::atomic<uint64_t> decoded_bytes_;
+    
+    std::atomic<uint64_t> observation_queries_;
+    std::atomic<uint64_t> observation_latest_hits_;
+    std::atomic<uint64_t> observation_fallbacks_;
+    std::atomic<uint64_t> observation_widenings_;
+    std::atomic<uint64_t> observation_unchanged_;
+    std::atomic<uint64_t> observation_bytes_saved_;
     
-    static constexpr const char* NWS_BASE_URL = "api.weather.gov";
+    static constexpr const char* NWS_BASE_URL = "https://api.weather.gov";
 };
 
 #endif // NWS_CLIENT_H
\ No newline at end of file
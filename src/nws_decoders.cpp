@@ -0,0 +1,539 @@
+#include "nws_decoders.h"
+#include <cctype>
+
+namespace {
+
+enum PointsField {
+    POINTS_FORECAST_GRID,
+    POINTS_STATIONS,
+    POINTS_FORECAST,
+    POINTS_FORECAST_HOURLY,
+    POINTS_GRID_ID,
+    POINTS_GRID_X,
+    POINTS_GRID_Y
+};
+
+enum StationsField {
+    STATION_ID,
+    STATION_NAME,
+    STATION_COORDINATE
+};
+
+enum ObservationField {
+    OBS_TIMESTAMP,
+    OBS_TEXT,
+    OBS_TEMPERATURE,
+    OBS_TEMPERATURE_QC,
+    OBS_DEWPOINT,
+    OBS_WIND_SPEED,
+    OBS_WIND_DIRECTION,
+    OBS_HUMIDITY,
+    OBS_PRESSURE
+};
+
+// Gridpoint series; each has a validTime and a value field
+enum GridpointSeriesId {
+    SERIES_TEMPERATURE,
+    SERIES_MAX_TEMPERATURE,
+    SERIES_MIN_TEMPERATURE,
+    SERIES_PRECIPITATION,
+    SERIES_SKY_COVER,
+    SERIES_WEATHER,
+    SERIES_COUNT
+};
+
+enum GridpointField {
+    GRID_VALID_TIME,
+    GRID_VALUE,
+    GRID_WEATHER,
+    GRID_INTENSITY,
+    GRID_FIELDS_PER_SERIES
+};
+
+constexpr int gridField(int series, int field) {
+    return series * GRID_FIELDS_PER_SERIES + field;
+}
+
+constexpr int GRID_PROPERTIES = SERIES_COUNT;
+
+// properties.updateTime; past every series' field ids
+constexpr int GRID_UPDATE_TIME = gridField(SERIES_COUNT, GRID_VALID_TIME);
+
+enum PeriodField {
+    PERIOD_TEMPERATURE,
+    PERIOD_ICON,
+    PERIOD_PRECIPITATION,
+    PERIOD_DETAILED_FORECAST
+};
+
+enum HourlyField {
+    HOURLY_START_TIME,
+    HOURLY_TEMPERATURE,
+    HOURLY_TEMPERATURE_UNIT,
+    HOURLY_PRECIPITATION,
+    HOURLY_HUMIDITY,
+    HOURLY_WIND_SPEED,
+    HOURLY_WIND_DIRECTION,
+    HOURLY_ICON
+};
+
+// Every decoder has a single record type
+constexpr int RECORD = 0;
+
+const JsonSchema& pointsSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .field("properties.forecastGridData", POINTS_FORECAST_GRID)
+        .field("properties.observationStations", POINTS_STATIONS)
+        .field("properties.forecast", POINTS_FORECAST)
+        .field("properties.forecastHourly", POINTS_FORECAST_HOURLY)
+        .field("properties.gridId", POINTS_GRID_ID)
+        .field("properties.gridX", POINTS_GRID_X)
+        .field("properties.gridY", POINTS_GRID_Y);
+    return schema;
+}
+
+const JsonSchema& stationsSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .record("features.*", RECORD)
+        .field("features.*.properties.stationIdentifier", STATION_ID)
+        .field("features.*.properties.name", STATION_NAME)
+        .field("features.*.geometry.coordinates.*", STATION_COORDINATE);
+    return schema;
+}
+
+const JsonSchema& observationSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .record("features.*", RECORD)
+        .field("features.*.properties.timestamp", OBS_TIMESTAMP)
+        .field("features.*.properties.textDescription", OBS_TEXT)
+        .field("features.*.properties.temperature.value", OBS_TEMPERATURE)
+        .field("features.*.properties.temperature.qualityControl", OBS_TEMPERATURE_QC)
+        .field("features.*.properties.dewpoint.value", OBS_DEWPOINT)
+        .field("features.*.properties.windSpeed.value", OBS_WIND_SPEED)
+        .field("features.*.properties.windDirection.value", OBS_WIND_DIRECTION)
+        .field("features.*.properties.relativeHumidity.value", OBS_HUMIDITY)
+        .field("features.*.properties.barometricPressure.value", OBS_PRESSURE);
+    return schema;
+}
+
+const JsonSchema& latestObservationSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .record("properties", RECORD)
+        .field("properties.timestamp", OBS_TIMESTAMP)
+        .field("properties.textDescription", OBS_TEXT)
+        .field("properties.temperature.value", OBS_TEMPERATURE)
+        .field("properties.temperature.qualityControl", OBS_TEMPERATURE_QC)
+        .field("properties.dewpoint.value", OBS_DEWPOINT)
+        .field("properties.windSpeed.value", OBS_WIND_SPEED)
+        .field("properties.windDirection.value", OBS_WIND_DIRECTION)
+        .field("properties.relativeHumidity.value", OBS_HUMIDITY)
+        .field("properties.barometricPressure.value", OBS_PRESSURE);
+    return schema;
+}
+
+const JsonSchema& gridpointSchema() {
+    static const JsonSchema schema = [] {
+        const std::pair<int, const char*> numeric[] = {
+            {SERIES_TEMPERATURE, "temperature"},
+            {SERIES_MAX_TEMPERATURE, "maxTemperature"},
+            {SERIES_MIN_TEMPERATURE, "minTemperature"},
+            {SERIES_PRECIPITATION, "probabilityOfPrecipitation"},
+            {SERIES_SKY_COVER, "skyCover"}
+        };
+
+        JsonSchema schema;
+        schema.record("properties", GRID_PROPERTIES)
+              .field("properties.updateTime", GRID_UPDATE_TIME);
+        for (const auto& series : numeric) {
+            std::string values = std::string("properties.") + series.second + ".values.*";
+            schema.record(values, series.first)
+                  .field(values + ".validTime", gridField(series.first, GRID_VALID_TIME))
+                  .field(values + ".value", gridField(series.first, GRID_VALUE));
+        }
+        schema.record("properties.weather.values.*", SERIES_WEATHER)
+              .field("properties.weather.values.*.validTime", gridField(SERIES_WEATHER, GRID_VALID_TIME))
+              .field("properties.weather.values.*.value.*.weather", gridField(SERIES_WEATHER, GRID_WEATHER))
+              .field("properties.weather.values.*.value.*.intensity", gridField(SERIES_WEATHER, GRID_INTENSITY));
+        return schema;
+    }();
+    return schema;
+}
+
+const JsonSchema& forecastPeriodSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .record("properties.periods.*", RECORD)
+        .field("properties.periods.*.temperature", PERIOD_TEMPERATURE)
+        .field("properties.periods.*.icon", PERIOD_ICON)
+        .field("properties.periods.*.probabilityOfPrecipitation.value", PERIOD_PRECIPITATION)
+        .field("properties.periods.*.detailedForecast", PERIOD_DETAILED_FORECAST);
+    return schema;
+}
+
+const JsonSchema& hourlyForecastSchema() {
+    static const JsonSchema schema = JsonSchema()
+        .record("properties.periods.*", RECORD)
+        .field("properties.periods.*.startTime", HOURLY_START_TIME)
+        .field("properties.periods.*.temperature", HOURLY_TEMPERATURE)
+        .field("properties.periods.*.temperatureUnit", HOURLY_TEMPERATURE_UNIT)
+        .field("properties.periods.*.probabilityOfPrecipitation.value", HOURLY_PRECIPITATION)
+        .field("properties.periods.*.relativeHumidity.value", HOURLY_HUMIDITY)
+        .field("properties.periods.*.windSpeed", HOURLY_WIND_SPEED)
+        .field("properties.periods.*.windDirection", HOURLY_WIND_DIRECTION)
+        .field("properties.periods.*.icon", HOURLY_ICON);
+    return schema;
+}
+
+// "10 mph" or "5 to 10 mph"; the upper figure, in km/h
+std::optional<double> parseWindSpeed(const std::string& text) {
+    double speed = 0.0;
+    bool found = false;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            size_t used = 0;
+            speed = std::stod(text.substr(pos), &used);
+            pos += used;
+            found = true;
+        } else {
+            pos++;
+        }
+    }
+    if (!found) {
+        return std::nullopt;
+    }
+    return text.find("km/h") != std::string::npos ? speed : speed * 1.609344;
+}
+
+// 16-point compass abbreviation to degrees
+std::optional<int> parseCompassDirection(const std::string& text) {
+    static const char* points[] = {
+        "N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+        "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"
+    };
+    for (int i = 0; i < 16; i++) {
+        if (text == points[i]) {
+            return static_cast<int>(i * 22.5 + 0.5);
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+PointsDecoder::PointsDecoder()
+    : SchemaSaxDecoder(pointsSchema())
+{
+}
+
+bool PointsDecoder::onField(int field_id, const Value& value) {
+    if (value.isString()) {
+        switch (field_id) {
+            case POINTS_FORECAST_GRID: points.forecast_grid_url = *value.string; break;
+            case POINTS_STATIONS: points.stations_url = *value.string; break;
+            case POINTS_FORECAST: points.forecast_url = *value.string; break;
+            case POINTS_FORECAST_HOURLY: points.forecast_hourly_url = *value.string; break;
+            case POINTS_GRID_ID: points.office_id = *value.string; break;
+            default: break;
+        }
+    } else if (value.isNumber()) {
+        switch (field_id) {
+            case POINTS_GRID_X: points.grid_x = static_cast<int>(value.number); break;
+            case POINTS_GRID_Y: points.grid_y = static_cast<int>(value.number); break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+StationsDecoder::StationsDecoder()
+    : SchemaSaxDecoder(stationsSchema())
+{
+}
+
+bool StationsDecoder::onRecordStart(int) {
+    current_ = NWSStation();
+    has_id_ = false;
+    return true;
+}
+
+bool StationsDecoder::onField(int field_id, const Value& value) {
+    switch (field_id) {
+        case STATION_ID:
+            if (value.isString()) {
+                current_.id = *value.string;
+                has_id_ = true;
+            }
+            break;
+        case STATION_NAME:
+            if (value.isString()) {
+                current_.name = *value.string;
+            }
+            break;
+        case STATION_COORDINATE:
+            // GeoJSON coordinates are [longitude, latitude]
+            if (value.isNumber()) {
+                if (elementIndex() == 0) {
+                    current_.longitude = value.number;
+                } else if (elementIndex() == 1) {
+                    current_.latitude = value.number;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool StationsDecoder::onRecordEnd(int) {
+    if (has_id_) {
+        stations.push_back(current_);
+    }
+    return true;
+}
+
+ObservationDecoder::ObservationDecoder(Shape shape, const NWSObservation* held)
+    : SchemaSaxDecoder(shape == Shape::Single ? latestObservationSchema() : observationSchema())
+    , held_(held != nullptr && held->valid && !held->timestamp.empty() ? held : nullptr)
+{
+}
+
+bool ObservationDecoder::onRecordStart(int) {
+    current_ = NWSObservation();
+    temperature_qc_.clear();
+    return true;
+}
+
+bool ObservationDecoder::onField(int field_id, const Value& value) {
+    if (field_id == OBS_TIMESTAMP || field_id == OBS_TEXT || field_id == OBS_TEMPERATURE_QC) {
+        if (!value.isString()) {
+            return true;
+        }
+        // Anything newer than the held reading came first and failed QC,
+        // so the held reading is still the answer
+        if (field_id == OBS_TIMESTAMP && held_ != nullptr && *value.string == held_->timestamp) {
+            feature_count++;
+            observation = *held_;
+            unchanged = true;
+            return stop();
+        }
+        switch (field_id) {
+            case OBS_TIMESTAMP: current_.timestamp = *value.string; break;
+            case OBS_TEXT: current_.text_description = *value.string; break;
+            case OBS_TEMPERATURE_QC: temperature_qc_ = *value.string; break;
+        }
+        return true;
+    }
+
+    if (!value.isNumber()) {
+        return true;
+    }
+
+    switch (field_id) {
+        case OBS_TEMPERATURE: current_.temperature_celsius = value.number; break;
+        case OBS_DEWPOINT: current_.dewpoint_celsius = value.number; break;
+        case OBS_WIND_SPEED: current_.wind_speed_kmh = value.number; break;
+        case OBS_WIND_DIRECTION: current_.wind_direction_degrees = static_cast<int>(value.number); break;
+        case OBS_HUMIDITY: current_.humidity_percent = value.number; break;
+        case OBS_PRESSURE: current_.pressure_pa = value.number; break;
+        default: break;
+    }
+    return true;
+}
+
+bool ObservationDecoder::onRecordEnd(int) {
+    feature_count++;
+
+    // Keep the first reading whose temperature passed quality control
+    if (temperature_qc_ == "V") {
+        observation = current_;
+        observation.valid = true;
+        return stop();
+    }
+    return true;
+}
+
+GridpointDecoder::GridpointDecoder()
+    : SchemaSaxDecoder(gridpointSchema())
+{
+}
+
+bool GridpointDecoder::onRecordStart(int record_id) {
+    if (record_id == GRID_PROPERTIES) {
+        has_properties = true;
+        return true;
+    }
+
+    has_time_ = false;
+    value_.reset();
+    weather_.clear();
+    intensity_.clear();
+    return true;
+}
+
+bool GridpointDecoder::onField(int field_id, const Value& value) {
+    if (field_id == GRID_UPDATE_TIME) {
+        if (value.isString()) {
+            parseIsoTimestamp(*value.string, series.update_time);
+        }
+        return true;
+    }
+
+    switch (field_id % GRID_FIELDS_PER_SERIES) {
+        case GRID_VALID_TIME:
+            // Parsed once here; lookups afterwards are binary searches
+            if (value.isString()) {
+                has_time_ = parseValidTime(*value.string, start_, end_);
+            }
+            break;
+        case GRID_VALUE:
+            if (value.isNumber()) value_ = value.number;
+            break;
+        case GRID_WEATHER:
+            // Only the first condition of each interval is used
+            if (value.isString() && elementIndex() == 0) weather_ = *value.string;
+            break;
+        case GRID_INTENSITY:
+            if (value.isString() && elementIndex() == 0) intensity_ = *value.string;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool GridpointDecoder::onRecordEnd(int record_id) {
+    if (record_id == GRID_PROPERTIES || !has_time_) {
+        return true;
+    }
+
+    switch (record_id) {
+        case SERIES_WEATHER:
+            series.weather.append(start_, end_, weather_, intensity_);
+            return true;
+        case SERIES_TEMPERATURE:
+            if (value_) series.temperature.append(start_, end_, *value_);
+            break;
+        case SERIES_MAX_TEMPERATURE:
+            if (value_) series.max_temperature.append(start_, end_, *value_);
+            break;
+        case SERIES_MIN_TEMPERATURE:
+            if (value_) series.min_temperature.append(start_, end_, *value_);
+            break;
+        case SERIES_PRECIPITATION:
+            if (value_) series.precipitation_chance.append(start_, end_, *value_);
+            break;
+        case SERIES_SKY_COVER:
+            if (value_) series.sky_cover.append(start_, end_, *value_);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+ForecastPeriodDecoder::ForecastPeriodDecoder()
+    : SchemaSaxDecoder(forecastPeriodSchema())
+{
+}
+
+bool ForecastPeriodDecoder::onField(int field_id, const Value& value) {
+    switch (field_id) {
+        case PERIOD_TEMPERATURE:
+            if (value.isNumber()) {
+                // Period temperatures are reported in Fahrenheit
+                forecast.temperature_max_celsius = (value.number - 32.0) * 5.0 / 9.0;
+            }
+            break;
+        case PERIOD_ICON:
+            if (value.isString()) icon_url = *value.string;
+            break;
+        case PERIOD_PRECIPITATION:
+            if (value.isNumber()) forecast.precipitation_chance_percent = static_cast<int>(value.number);
+            break;
+        case PERIOD_DETAILED_FORECAST:
+            if (value.isString()) forecast.weather_condition = *value.string;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool ForecastPeriodDecoder::onRecordEnd(int) {
+    // Only the first (current) period is needed
+    period_count++;
+    forecast.valid = true;
+    return stop();
+}
+
+HourlyForecastDecoder::HourlyForecastDecoder(IconMapper icon_mapper)
+    : SchemaSaxDecoder(hourlyForecastSchema())
+    , icon_mapper_(std::move(icon_mapper))
+{
+}
+
+bool HourlyForecastDecoder::onRecordStart(int) {
+    current_ = HourlyPoint();
+    has_time_ = false;
+    temperature_.reset();
+    fahrenheit_ = true;
+    return true;
+}
+
+bool HourlyForecastDecoder::onField(int field_id, const Value& value) {
+    if (value.isNumber()) {
+        switch (field_id) {
+            case HOURLY_TEMPERATURE: temperature_ = value.number; break;
+            case HOURLY_PRECIPITATION: current_.precipitation_percent = static_cast<int>(value.number); break;
+            case HOURLY_HUMIDITY: current_.humidity_percent = static_cast<int>(value.number); break;
+            default: break;
+        }
+        return true;
+    }
+
+    if (!value.isString()) {
+        return true;
+    }
+
+    switch (field_id) {
+        case HOURLY_START_TIME: {
+            int64_t start = 0;
+            has_time_ = parseIsoTimestamp(*value.string, start);
+            current_.time = static_cast<std::time_t>(start);
+            break;
+        }
+        case HOURLY_TEMPERATURE_UNIT:
+            fahrenheit_ = (*value.string != "C");
+            break;
+        case HOURLY_WIND_SPEED:
+            current_.wind_speed_kmh = parseWindSpeed(*value.string);
+            break;
+        case HOURLY_WIND_DIRECTION:
+            current_.wind_direction_deg = parseCompassDirection(*value.string);
+            break;
+        case HOURLY_ICON:
+            if (icon_mapper_) {
+                int code = icon_mapper_(*value.string);
+                if (code >= 0) {
+                    current_.icon_code = code;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool HourlyForecastDecoder::onRecordEnd(int) {
+    if (!has_time_) {
+        return true;
+    }
+    // The unit may follow the value, so convert once the period is complete
+    if (temperature_.has_value()) {
+        current_.temperature_c = fahrenheit_ ? (*temperature_ - 32.0) * 5.0 / 9.0 : *temperature_;
+    }
+    hourly.append(current_);
+    return true;
+}
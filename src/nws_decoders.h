@@ -0,0 +1,129 @@
+#ifndef NWS_DECODERS_H
+#define NWS_DECODERS_H
+
+#include "json_schema_decoder.h"
+#include "nws_client.h"
+#include "gridpoint_series.h"
+#include "hourly_forecast.h"
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <functional>
+
+/**
+ * Streaming decoders for the NWS API responses.
+ * Each decoder fills its target struct straight from the SAX event stream
+ * and ignores every subtree it does not need.
+ */
+
+// /points/{lat},{lon}
+class PointsDecoder : public SchemaSaxDecoder {
+public:
+    PointsDecoder();
+    NWSPoints points;
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+};
+
+// /gridpoints/{office}/{x},{y}/stations
+class StationsDecoder : public SchemaSaxDecoder {
+public:
+    StationsDecoder();
+    std::vector<NWSStation> stations;
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+    bool onRecordStart(int record_id) override;
+    bool onRecordEnd(int record_id) override;
+
+private:
+    NWSStation current_;
+    bool has_id_ = false;
+};
+
+// /stations/{id}/observations[?limit=N]: stops at the first feature whose
+// temperature passed quality control. /stations/{id}/observations/latest
+// returns a single feature instead of a collection. Given the reading
+// already held for the station, it also stops at the feature carrying that
+// reading's timestamp and hands the held reading back, unparsed.
+class ObservationDecoder : public SchemaSaxDecoder {
+public:
+    enum class Shape { Collection, Single };
+
+    explicit ObservationDecoder(Shape shape = Shape::Collection, const NWSObservation* held = nullptr);
+    NWSObservation observation;
+    int feature_count = 0;  // Features examined before stopping
+    bool unchanged = false; // Stopped at the held reading
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+    bool onRecordStart(int record_id) override;
+    bool onRecordEnd(int record_id) override;
+
+private:
+    NWSObservation current_;
+    std::string temperature_qc_;
+    const NWSObservation* held_;
+};
+
+// /gridpoints/{office}/{x},{y}: indexes every validTime interval of the
+// series the display uses
+class GridpointDecoder : public SchemaSaxDecoder {
+public:
+    GridpointDecoder();
+    GridpointSeries series;
+    bool has_properties = false;
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+    bool onRecordStart(int record_id) override;
+    bool onRecordEnd(int record_id) override;
+
+private:
+    bool has_time_ = false;
+    int64_t start_ = 0;
+    int64_t end_ = 0;
+    std::optional<double> value_;
+    std::string weather_;
+    std::string intensity_;
+};
+
+// /gridpoints/{office}/{x},{y}/forecast: stops after the first period
+class ForecastPeriodDecoder : public SchemaSaxDecoder {
+public:
+    ForecastPeriodDecoder();
+    NWSForecast forecast;
+    std::string icon_url;
+    int period_count = 0;
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+    bool onRecordEnd(int record_id) override;
+};
+
+// /gridpoints/{office}/{x},{y}/forecast/hourly: packs every period into
+// the columnar store without keeping any per-period strings
+class HourlyForecastDecoder : public SchemaSaxDecoder {
+public:
+    // Maps an NWS icon URL to a numbered icon code, or -1 if unknown
+    using IconMapper = std::function<int(const std::string& icon_url)>;
+
+    explicit HourlyForecastDecoder(IconMapper icon_mapper);
+    HourlyForecast hourly;
+
+protected:
+    bool onField(int field_id, const Value& value) override;
+    bool onRecordStart(int record_id) override;
+    bool onRecordEnd(int record_id) override;
+
+private:
+    IconMapper icon_mapper_;
+    HourlyPoint current_;
+    bool has_time_ = false;
+    std::optional<double> temperature_;
+    bool fahrenheit_ = true;
+};
+
+#endif // NWS_DECODERS_H
@@ -0,0 +1,179 @@
+#include "response_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <sstream>
+
+namespace {
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(start, end - start + 1);
+}
+
+// Parse an IMF-fixdate such as "Wed, 21 Oct 2015 07:28:00 GMT"
+std::optional<std::time_t> parseHttpDate(const std::string& value) {
+    if (value.empty()) {
+        return std::nullopt;
+    }
+
+    std::tm tm = {};
+    if (strptime(value.c_str(), "%a, %d %b %Y %H:%M:%S", &tm) == nullptr) {
+        return std::nullopt;
+    }
+    return timegm(&tm);
+}
+
+bool hasDirective(const std::string& cache_control, const std::string& directive) {
+    std::stringstream ss(toLower(cache_control));
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        if (trim(token) == directive) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ResponseCache::ResponseCache(size_t max_entries)
+    : max_entries_(max_entries)
+{
+}
+
+std::optional<ResponseCache::Entry> ResponseCache::lookup(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void ResponseCache::store(const std::string& path, const Headers& headers, std::any decoded) {
+    if (hasDirective(headers.cache_control, "no-store")) {
+        return;
+    }
+
+    Entry entry;
+    entry.etag = headers.etag;
+    entry.last_modified = headers.last_modified;
+    entry.stored_at = Clock::now();
+    entry.expires_at = entry.stored_at + freshnessLifetime(headers);
+    entry.decoded = std::move(decoded);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[path] = std::move(entry);
+    if (entries_.size() > max_entries_) {
+        evictOldest();
+    }
+}
+
+void ResponseCache::revalidate(const std::string& path, const Headers& headers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    // A 304 may carry updated validators
+    if (!headers.etag.empty()) {
+        it->second.etag = headers.etag;
+    }
+    if (!headers.last_modified.empty()) {
+        it->second.last_modified = headers.last_modified;
+    }
+    it->second.stored_at = Clock::now();
+    it->second.expires_at = it->second.stored_at + freshnessLifetime(headers);
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+void ResponseCache::recordFreshHit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.fresh_hits++;
+}
+
+void ResponseCache::recordNotModified() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.not_modified++;
+}
+
+void ResponseCache::recordMiss() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.misses++;
+}
+
+CacheStats ResponseCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::chrono::seconds ResponseCache::freshnessLifetime(const Headers& headers) {
+    if (hasDirective(headers.cache_control, "no-cache")) {
+        return std::chrono::seconds(0);
+    }
+
+    long lifetime = 0;
+    bool have_lifetime = false;
+
+    // max-age takes precedence over Expires
+    std::stringstream ss(toLower(headers.cache_control));
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.rfind("max-age=", 0) == 0) {
+            try {
+                lifetime = std::stol(token.substr(8));
+                have_lifetime = true;
+            } catch (...) {
+                // Malformed max-age, treat as stale
+            }
+            break;
+        }
+    }
+
+    if (!have_lifetime) {
+        // Measure Expires against the server's Date to avoid local clock skew
+        auto expires = parseHttpDate(headers.expires);
+        auto date = parseHttpDate(headers.date);
+        if (expires.has_value()) {
+            std::time_t reference = date.value_or(std::time(nullptr));
+            lifetime = static_cast<long>(expires.value() - reference);
+        }
+    }
+
+    if (!headers.age.empty()) {
+        try {
+            lifetime -= std::stol(headers.age);
+        } catch (...) {
+            // Ignore malformed Age
+        }
+    }
+
+    return std::chrono::seconds(std::max(0L, lifetime));
+}
+
+void ResponseCache::evictOldest() {
+    auto oldest = std::min_element(entries_.begin(), entries_.end(),
+                                   [](const auto& a, const auto& b) {
+                                       return a.second.stored_at < b.second.stored_at;
+                                   });
+    if (oldest != entries_.end()) {
+        entries_.erase(oldest);
+    }
+}
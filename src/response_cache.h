@@ -0,0 +1,80 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include <any>
+#include <cstdint>
+
+struct CacheStats {
+    uint64_t fresh_hits = 0;     // Served without touching the network
+    uint64_t not_modified = 0;   // Revalidated with a 304 response
+    uint64_t misses = 0;         // Full body downloaded and parsed
+};
+
+/**
+ * HTTP response cache keyed by URL path.
+ * Stores the decoded response together with its validators (ETag and
+ * Last-Modified) and the freshness lifetime from Cache-Control/Expires, so
+ * callers can skip the network while fresh and send conditional requests
+ * once stale.
+ */
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string etag;
+        std::string last_modified;
+        Clock::time_point stored_at;
+        Clock::time_point expires_at;
+        std::any decoded;  // Typed result of decoding the body
+
+        bool isFresh(Clock::time_point now) const { return now < expires_at; }
+    };
+
+    // Response headers relevant to caching
+    struct Headers {
+        std::string etag;
+        std::string last_modified;
+        std::string cache_control;
+        std::string expires;
+        std::string date;
+        std::string age;
+    };
+
+    explicit ResponseCache(size_t max_entries = 32);
+
+    std::optional<Entry> lookup(const std::string& path) const;
+
+    // Store a freshly downloaded response (ignored for Cache-Control: no-store)
+    void store(const std::string& path, const Headers& headers, std::any decoded);
+
+    // Extend the lifetime of an entry after a 304 Not Modified response
+    void revalidate(const std::string& path, const Headers& headers);
+
+    void clear();
+
+    void recordFreshHit();
+    void recordNotModified();
+    void recordMiss();
+    CacheStats getStats() const;
+
+    // Freshness lifetime from Cache-Control max-age, or Expires minus Date,
+    // less the Age already spent in upstream caches
+    static std::chrono::seconds freshnessLifetime(const Headers& headers);
+
+private:
+    void evictOldest();
+
+    size_t max_entries_;
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+    CacheStats stats_;
+};
+
+#endif // RESPONSE_CACHE_H
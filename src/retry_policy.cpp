@@ -0,0 +1,215 @@
+#include "retry_policy.h"
+#include <algorithm>
+
+const char* endpointClassName(EndpointClass endpoint) {
+    switch (endpoint) {
+        case EndpointClass::Points: return "points";
+        case EndpointClass::Stations: return "stations";
+        case EndpointClass::Observations: return "observations";
+        case EndpointClass::Gridpoint: return "gridpoint";
+        case EndpointClass::Forecast: return "forecast";
+        case EndpointClass::HourlyForecast: return "hourly";
+        default: return "unknown";
+    }
+}
+
+EndpointClass classifyEndpoint(const std::string& path) {
+    if (path.rfind("/points/", 0) == 0) {
+        return EndpointClass::Points;
+    }
+    if (path.find("/observations") != std::string::npos) {
+        return EndpointClass::Observations;
+    }
+    if (path.find("/forecast/hourly") != std::string::npos) {
+        return EndpointClass::HourlyForecast;
+    }
+    if (path.find("/forecast") != std::string::npos) {
+        return EndpointClass::Forecast;
+    }
+    if (path.find("/stations") != std::string::npos) {
+        return EndpointClass::Stations;
+    }
+    return EndpointClass::Gridpoint;
+}
+
+const char* circuitStateName(CircuitBreaker::State state) {
+    switch (state) {
+        case CircuitBreaker::State::Closed: return "closed";
+        case CircuitBreaker::State::Open: return "open";
+        case CircuitBreaker::State::HalfOpen: return "half-open";
+    }
+    return "unknown";
+}
+
+std::chrono::milliseconds RetryPolicy::backoff(int retry, std::mt19937& rng) const {
+    // Bounded exponential growth; the shift is clamped so it cannot overflow
+    int exponent = std::clamp(retry - 1, 0, 20);
+    int64_t ceiling = std::min<int64_t>(max_delay.count(), base_delay.count() << exponent);
+    if (ceiling <= 0) {
+        return std::chrono::milliseconds(0);
+    }
+    std::uniform_int_distribution<int64_t> jitter(0, ceiling);
+    return std::chrono::milliseconds(jitter(rng));
+}
+
+bool CircuitBreaker::allowRequest(Clock::time_point now, bool* probe) {
+    if (probe != nullptr) {
+        *probe = false;
+    }
+    switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (now < open_until_) {
+                return false;
+            }
+            state_ = State::HalfOpen;
+            probe_in_flight_ = true;
+            if (probe != nullptr) {
+                *probe = true;
+            }
+            return true;
+        case State::HalfOpen:
+            // Only the single probe request is let through
+            if (probe_in_flight_) {
+                return false;
+            }
+            probe_in_flight_ = true;
+            if (probe != nullptr) {
+                *probe = true;
+            }
+            return true;
+    }
+    return true;
+}
+
+void CircuitBreaker::recordSuccess() {
+    state_ = State::Closed;
+    consecutive_failures_ = 0;
+    probe_in_flight_ = false;
+}
+
+void CircuitBreaker::releaseProbe() {
+    // Stay half-open so the next request becomes the probe
+    if (state_ == State::HalfOpen) {
+        probe_in_flight_ = false;
+    }
+}
+
+void CircuitBreaker::recordFailure(Clock::time_point now, const RetryPolicy& policy) {
+    consecutive_failures_++;
+    probe_in_flight_ = false;
+    if (state_ == State::HalfOpen || consecutive_failures_ >= policy.failure_threshold) {
+        state_ = State::Open;
+        open_until_ = now + policy.open_duration;
+    }
+}
+
+RetryController::RetryController()
+    : rng_(std::random_device{}())
+{
+    // Resolution endpoints change rarely and are needed before anything
+    // else, so they get the most patience
+    RetryPolicy resolve;
+    resolve.max_attempts = 4;
+    resolve.budget = std::chrono::milliseconds(25000);
+
+    // Current conditions are worth a couple of quick retries
+    RetryPolicy observations;
+    observations.max_attempts = 3;
+    observations.budget = std::chrono::milliseconds(15000);
+
+    // The gridpoint endpoint is the one most prone to 5xx responses
+    RetryPolicy gridpoint;
+    gridpoint.max_attempts = 3;
+    gridpoint.base_delay = std::chrono::milliseconds(1000);
+    gridpoint.budget = std::chrono::milliseconds(20000);
+
+    // The period forecast is only a fallback for the gridpoint data
+    RetryPolicy forecast;
+    forecast.max_attempts = 1;
+
+    RetryPolicy hourly;
+    hourly.max_attempts = 2;
+    hourly.budget = std::chrono::milliseconds(15000);
+
+    state(EndpointClass::Points).policy = resolve;
+    state(EndpointClass::Stations).policy = resolve;
+    state(EndpointClass::Observations).policy = observations;
+    state(EndpointClass::Gridpoint).policy = gridpoint;
+    state(EndpointClass::Forecast).policy = forecast;
+    state(EndpointClass::HourlyForecast).policy = hourly;
+
+    for (size_t i = 0; i < endpoints_.size(); i++) {
+        endpoints_[i].stats.endpoint = endpointClassName(static_cast<EndpointClass>(i));
+    }
+}
+
+RetryPolicy RetryController::policy(EndpointClass endpoint) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return endpoints_[static_cast<size_t>(endpoint)].policy;
+}
+
+void RetryController::setPolicy(EndpointClass endpoint, const RetryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).policy = policy;
+}
+
+bool RetryController::allowRequest(EndpointClass endpoint, bool* probe) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state(endpoint).breaker.allowRequest(CircuitBreaker::Clock::now(), probe);
+}
+
+std::chrono::milliseconds RetryController::backoff(EndpointClass endpoint, int retry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state(endpoint).policy.backoff(retry, rng_);
+}
+
+void RetryController::recordRequest(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).stats.requests++;
+}
+
+void RetryController::recordRetry(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).stats.retries++;
+}
+
+void RetryController::recordSuccess(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).breaker.recordSuccess();
+}
+
+void RetryController::recordFailure(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EndpointState& s = state(endpoint);
+    s.stats.failures++;
+    s.breaker.recordFailure(CircuitBreaker::Clock::now(), s.policy);
+}
+
+void RetryController::recordAbandoned(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).breaker.releaseProbe();
+}
+
+void RetryController::recordShortCircuit(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).stats.short_circuited++;
+}
+
+void RetryController::recordStaleServed(EndpointClass endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state(endpoint).stats.stale_served++;
+}
+
+std::vector<EndpointRetryStats> RetryController::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<EndpointRetryStats> stats;
+    for (const auto& endpoint : endpoints_) {
+        EndpointRetryStats s = endpoint.stats;
+        s.state = endpoint.breaker.state();
+        s.consecutive_failures = endpoint.breaker.consecutiveFailures();
+        stats.push_back(s);
+    }
+    return stats;
+}
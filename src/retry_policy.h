@@ -0,0 +1,152 @@
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+// Groups of NWS endpoints that share a retry budget and a circuit breaker
+enum class EndpointClass {
+    Points,
+    Stations,
+    Observations,
+    Gridpoint,
+    Forecast,
+    HourlyForecast,
+    Count
+};
+
+const char* endpointClassName(EndpointClass endpoint);
+
+// Endpoint class of an api.weather.gov path
+EndpointClass classifyEndpoint(const std::string& path);
+
+struct RetryPolicy {
+    int max_attempts = 3;                                // Including the first try
+    std::chrono::milliseconds base_delay{500};           // Backoff before the first retry
+    std::chrono::milliseconds max_delay{8000};           // Cap on a single backoff
+    std::chrono::milliseconds budget{20000};             // Total time one request may spend
+    int failure_threshold = 3;                           // Consecutive failures that open the breaker
+    std::chrono::seconds open_duration{60};              // Time the breaker stays open
+
+    // "Full jitter" backoff before the given retry (1-based):
+    // uniform in [0, min(max_delay, base_delay * 2^(retry-1))], inclusive
+    std::chrono::milliseconds backoff(int retry, std::mt19937& rng) const;
+};
+
+/**
+ * Classic three-state circuit breaker. Closed lets everything through;
+ * after failure_threshold consecutive failures it opens and rejects
+ * requests for open_duration, then half-opens to let a single probe
+ * request decide whether to close again. A probe that ends without an
+ * answer (cancelled, aborted) must be released with releaseProbe().
+ */
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+    enum class State { Closed, Open, HalfOpen };
+
+    // probe is set when the request let through is the half-open probe
+    bool allowRequest(Clock::time_point now, bool* probe = nullptr);
+    void recordSuccess();
+    void recordFailure(Clock::time_point now, const RetryPolicy& policy);
+    void releaseProbe();
+
+    State state() const { return state_; }
+    int consecutiveFailures() const { return consecutive_failures_; }
+
+private:
+    State state_ = State::Closed;
+    int consecutive_failures_ = 0;
+    bool probe_in_flight_ = false;
+    Clock::time_point open_until_;
+};
+
+const char* circuitStateName(CircuitBreaker::State state);
+
+struct EndpointRetryStats {
+    const char* endpoint = "";
+    uint64_t requests = 0;
+    uint64_t retries = 0;
+    uint64_t failures = 0;          // Requests that failed after every retry
+    uint64_t short_circuited = 0;   // Rejected while the breaker was open
+    uint64_t stale_served = 0;      // Answered from a stale cache entry instead
+    CircuitBreaker::State state = CircuitBreaker::State::Closed;
+    int consecutive_failures = 0;
+};
+
+/**
+ * Retry budgets and circuit breakers for every endpoint class.
+ * Thread-safe; shared by all requests of one NWSClient.
+ */
+class RetryController {
+public:
+    RetryController();
+
+    RetryPolicy policy(EndpointClass endpoint) const;
+    void setPolicy(EndpointClass endpoint, const RetryPolicy& policy);
+
+    // False while the endpoint's breaker is open; probe is set when the
+    // request is the breaker's half-open probe
+    bool allowRequest(EndpointClass endpoint, bool* probe = nullptr);
+
+    // Backoff before the given retry (1-based), with jitter
+    std::chrono::milliseconds backoff(EndpointClass endpoint, int retry);
+
+    void recordRequest(EndpointClass endpoint);
+    void recordRetry(EndpointClass endpoint);
+    void recordSuccess(EndpointClass endpoint);
+    void recordFailure(EndpointClass endpoint);
+    void recordAbandoned(EndpointClass endpoint);   // Probe ended with neither
+    void recordShortCircuit(EndpointClass endpoint);
+    void recordStaleServed(EndpointClass endpoint);
+
+    std::vector<EndpointRetryStats> getStats() const;
+
+private:
+    struct EndpointState {
+        RetryPolicy policy;
+        CircuitBreaker breaker;
+        EndpointRetryStats stats;
+    };
+
+    EndpointState& state(EndpointClass endpoint) { return endpoints_[static_cast<size_t>(endpoint)]; }
+
+    mutable std::mutex mutex_;
+    std::array<EndpointState, static_cast<size_t>(EndpointClass::Count)> endpoints_;
+    std::mt19937 rng_;
+};
+
+/**
+ * Releases a half-open probe on every exit that recorded neither a success
+ * nor a failure: cancellation, an aborted download or an exception. Without
+ * it the breaker would stay half-open with its probe taken and reject the
+ * endpoint until restart.
+ */
+class ProbeGuard {
+public:
+    ProbeGuard(RetryController& retry, EndpointClass endpoint, bool probe)
+        : retry_(retry), endpoint_(endpoint), active_(probe) {}
+    ~ProbeGuard() {
+        if (active_) {
+            retry_.recordAbandoned(endpoint_);
+        }
+    }
+
+    ProbeGuard(const ProbeGuard&) = delete;
+    ProbeGuard& operator=(const ProbeGuard&) = delete;
+
+    // The probe's outcome has been recorded
+    void settle() { active_ = false; }
+
+private:
+    RetryController& retry_;
+    EndpointClass endpoint_;
+    bool active_;
+};
+
+#endif // RETRY_POLICY_H
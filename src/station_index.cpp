@@ -0,0 +1,220 @@
+#include "station_index.h"
+#include "gridpoint_series.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+constexpr double EARTH_RADIUS_KM = 6371.0088;  // Mean radius
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// Weight of the newest attempt in the pass rate
+constexpr double PASS_RATE_WEIGHT = 0.3;
+
+} // namespace
+
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    double phi1 = lat1 * DEG_TO_RAD;
+    double phi2 = lat2 * DEG_TO_RAD;
+    double dphi = (lat2 - lat1) * DEG_TO_RAD;
+    double dlambda = (lon2 - lon1) * DEG_TO_RAD;
+    
+    double a = std::sin(dphi / 2) * std::sin(dphi / 2) +
+               std::cos(phi1) * std::cos(phi2) * std::sin(dlambda / 2) * std::sin(dlambda / 2);
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+std::vector<NWSStation> rankStations(std::vector<NWSStation> stations,
+                                     double latitude, double longitude, size_t k) {
+    for (auto& station : stations) {
+        station.distance_km = greatCircleKm(latitude, longitude, station.latitude, station.longitude);
+    }
+    
+    auto nearer = [](const NWSStation& a, const NWSStation& b) {
+        return a.distance_km < b.distance_km;
+    };
+    if (stations.size() > k) {
+        std::partial_sort(stations.begin(), stations.begin() + k, stations.end(), nearer);
+        stations.resize(k);
+    } else {
+        std::sort(stations.begin(), stations.end(), nearer);
+    }
+    return stations;
+}
+
+bool isFreshObservation(const NWSObservation& obs, std::time_t now, std::time_t max_age) {
+    if (!obs.valid) {
+        return false;
+    }
+    int64_t observed = 0;
+    if (!parseIsoTimestamp(obs.timestamp, observed)) {
+        return true;  // No usable timestamp; trust the QC result
+    }
+    return now - static_cast<std::time_t>(observed) <= max_age;
+}
+
+void StationIndex::reset(std::vector<NWSStation> ranked) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ranked_ = std::move(ranked);
+    
+    std::map<std::string, Health> kept;
+    for (const auto& station : ranked_) {
+        auto it = health_.find(station.id);
+        if (it != health_.end()) {
+            kept.insert(*it);
+        }
+    }
+    health_ = std::move(kept);
+}
+
+bool StationIndex::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ranked_.empty();
+}
+
+NWSStation StationIndex::primary() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ranked_.empty() ? NWSStation() : ranked_[0];
+}
+
+double StationIndex::score(const Health& health, std::time_t now) const {
+    if (health.last_valid == 0) {
+        return health.pass_rate;
+    }
+    // Full score while readings are fresh, then inversely with their age
+    std::time_t age = now - health.last_valid;
+    if (age <= STALE_OBSERVATION_SECONDS) {
+        return health.pass_rate;
+    }
+    return health.pass_rate * static_cast<double>(STALE_OBSERVATION_SECONDS) / static_cast<double>(age);
+}
+
+std::vector<NWSStation> StationIndex::candidates(std::time_t now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::vector<NWSStation> preferred;
+    std::vector<std::pair<double, NWSStation>> rest;
+    for (const auto& station : ranked_) {
+        auto it = health_.find(station.id);
+        if (it == health_.end()) {
+            preferred.push_back(station);
+            continue;
+        }
+        double s = score(it->second, now);
+        if (s >= HEALTHY_SCORE || now - it->second.last_attempt >= PROBE_INTERVAL) {
+            preferred.push_back(station);
+        } else {
+            rest.emplace_back(s, station);
+        }
+    }
+    
+    std::stable_sort(rest.begin(), rest.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (auto& entry : rest) {
+        preferred.push_back(std::move(entry.second));
+    }
+    return preferred;
+}
+
+void StationIndex::recordObservation(const std::string& station_id, const NWSObservation& obs, std::time_t now) {
+    bool fresh = isFreshObservation(obs, now);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    Health& health = health_[station_id];
+    health.attempts++;
+    health.last_attempt = now;
+    health.pass_rate = health.pass_rate * (1.0 - PASS_RATE_WEIGHT) + (fresh ? PASS_RATE_WEIGHT : 0.0);
+    if (obs.valid) {
+        health.last_reading = obs;
+    }
+    if (fresh) {
+        health.valid++;
+        int64_t observed = 0;
+        health.last_valid = parseIsoTimestamp(obs.timestamp, observed) ? static_cast<std::time_t>(observed) : now;
+    }
+}
+
+NWSObservation StationIndex::lastObservation(const std::string& station_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = health_.find(station_id);
+    return it != health_.end() ? it->second.last_reading : NWSObservation();
+}
+
+std::vector<StationHealthStats> StationIndex::getHealthStats(std::time_t now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<StationHealthStats> result;
+    for (const auto& station : ranked_) {
+        StationHealthStats stats;
+        stats.station_id = station.id;
+        stats.distance_km = station.distance_km;
+        auto it = health_.find(station.id);
+        if (it != health_.end()) {
+            stats.attempts = it->second.attempts;
+            stats.valid = it->second.valid;
+            stats.last_valid = it->second.last_valid;
+            stats.score = score(it->second, now);
+        }
+        stats.healthy = stats.score >= HEALTHY_SCORE;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+NWSObservation fetchObservationWithFailover(NWSClient& client, StationIndex& index, std::string* station_used,
+                                            std::chrono::steady_clock::time_point deadline) {
+    std::time_t now = std::time(nullptr);
+    std::vector<NWSStation> candidates = index.candidates(now);
+    if (candidates.size() > StationIndex::MAX_FAILOVER_STATIONS) {
+        candidates.resize(StationIndex::MAX_FAILOVER_STATIONS);
+    }
+    
+    NWSObservation best_stale;
+    std::string best_stale_station;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const NWSStation& station = candidates[i];
+        if (i > 0 && std::chrono::steady_clock::now() >= deadline) {
+            std::cout << "Station failover: out of time after " << i << " station(s)" << std::endl;
+            break;
+        }
+        bool answered = false;
+        NWSObservation held = index.lastObservation(station.id);
+        NWSObservation obs = client.getLatestObservation(station.id, deadline, &answered, &held);
+        now = std::time(nullptr);
+        
+        // Without a reply the station was never judged; the next one would
+        // be unreachable the same way, so stop rather than fail over
+        if (!answered) {
+            std::cout << "Station " << station.id << " unreachable: " << client.getLastError() << std::endl;
+            if (obs.valid && !best_stale.valid) {
+                best_stale = obs;
+                best_stale_station = station.id;
+            }
+            break;
+        }
+        index.recordObservation(station.id, obs, now);
+        
+        if (isFreshObservation(obs, now)) {
+            if (i > 0) {
+                std::cout << "Station failover: using " << station.id << " ("
+                          << static_cast<int>(station.distance_km) << " km)" << std::endl;
+            }
+            if (station_used) {
+                *station_used = station.id;
+            }
+            return obs;
+        }
+        
+        if (obs.valid && !best_stale.valid) {
+            best_stale = obs;
+            best_stale_station = station.id;
+        }
+        std::cout << "Station " << station.id << " has no current observation"
+                  << (i + 1 < candidates.size() ? ", trying next station" : "") << std::endl;
+    }
+    
+    if (station_used) {
+        *station_used = best_stale_station;
+    }
+    return best_stale;
+}
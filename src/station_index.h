@@ -0,0 +1,107 @@
+#ifndef STATION_INDEX_H
+#define STATION_INDEX_H
+
+#include "nws_client.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <ctime>
+#include <chrono>
+#include <cstdint>
+
+// Stations kept in a location's ranking
+constexpr size_t STATION_INDEX_SIZE = 10;
+
+// Great-circle (haversine) distance in kilometres
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2);
+
+// The k stations nearest to a location, nearest first, with distance_km
+// set. Only the k nearest are sorted; the rest are discarded.
+std::vector<NWSStation> rankStations(std::vector<NWSStation> stations,
+                                     double latitude, double longitude,
+                                     size_t k = STATION_INDEX_SIZE);
+
+// Per-station observation health, for diagnostics
+struct StationHealthStats {
+    std::string station_id;
+    double distance_km = 0.0;
+    uint32_t attempts = 0;
+    uint32_t valid = 0;             // Attempts that returned a fresh, QC-valid reading
+    std::time_t last_valid = 0;     // Observation time of the newest valid reading
+    double score = 1.0;
+    bool healthy = true;
+};
+
+/**
+ * Ranked stations for one location with a health score per station, so
+ * that an observation fetch can fail over to the next healthy station
+ * without another stations lookup. The score is an exponentially weighted
+ * pass rate over recent attempts, scaled down as the newest valid reading
+ * ages. Stations below HEALTHY_SCORE are skipped until PROBE_INTERVAL has
+ * passed since their last attempt. Safe to share between threads.
+ */
+class StationIndex {
+public:
+    static constexpr double HEALTHY_SCORE = 0.5;
+    static constexpr std::time_t PROBE_INTERVAL = 60 * 60;
+    // A reading older than this is treated as the station not reporting
+    static constexpr std::time_t STALE_OBSERVATION_SECONDS = 3 * 60 * 60;
+    // Stations tried per fetch before giving up
+    static constexpr size_t MAX_FAILOVER_STATIONS = 3;
+
+    StationIndex() = default;
+    explicit StationIndex(std::vector<NWSStation> ranked) { reset(std::move(ranked)); }
+
+    // Replace the ranking; health is kept for stations still in it
+    void reset(std::vector<NWSStation> ranked);
+
+    bool empty() const;
+    NWSStation primary() const;
+
+    // Stations to try, in order: healthy or probe-due stations by rank,
+    // then the rest by score
+    std::vector<NWSStation> candidates(std::time_t now) const;
+
+    // Score an attempt; obs may be invalid or stale
+    void recordObservation(const std::string& station_id, const NWSObservation& obs, std::time_t now);
+
+    // Newest valid reading from the station, or an invalid one
+    NWSObservation lastObservation(const std::string& station_id) const;
+
+    std::vector<StationHealthStats> getHealthStats(std::time_t now) const;
+
+private:
+    struct Health {
+        uint32_t attempts = 0;
+        uint32_t valid = 0;
+        double pass_rate = 1.0;         // Exponentially weighted
+        std::time_t last_valid = 0;
+        std::time_t last_attempt = 0;
+        NWSObservation last_reading;    // Lets the next fetch stop at it
+    };
+
+    double score(const Health& health, std::time_t now) const;
+
+    mutable std::mutex mutex_;
+    std::vector<NWSStation> ranked_;
+    std::map<std::string, Health> health_;
+};
+
+// True if obs is valid and its reading is no older than max_age at now
+bool isFreshObservation(const NWSObservation& obs, std::time_t now,
+                        std::time_t max_age = StationIndex::STALE_OBSERVATION_SECONDS);
+
+// Latest observation from the first candidate with a fresh, valid reading,
+// trying at most MAX_FAILOVER_STATIONS. If every candidate is stale the
+// best stale reading is returned. station_used receives the station id.
+// The whole failover shares one deadline: each station's retries stop at
+// it, and no further station is tried once it has passed.
+// Only stations whose server replied are scored; a network failure, open
+// breaker or expired deadline ends the failover instead.
+NWSObservation fetchObservationWithFailover(NWSClient& client, StationIndex& index,
+                                            std::string* station_used = nullptr,
+                                            std::chrono::steady_clock::time_point deadline =
+                                                std::chrono::steady_clock::time_point::max());
+
+#endif // STATION_INDEX_H
@@ -1,9 +1,40 @@
 #include "nws_client.h"
 #include "weather_service.h"
+#include "multi_location_service.h"
+#include "traffic_archive.h"
 #include <iostream>
 #include <iomanip>
 #include <ctime>
 
+// Request gzip/deflate responses (--compress)
+static bool g_use_compression = false;
+
+// Server to test against (--base-url), e.g. a local mock_nws_server
+static std::string g_base_url = "https://api.weather.gov";
+
+// Capture traffic to an archive (--record), or serve it back with no
+// network at all (--replay, --replay-timing)
+static std::shared_ptr<TrafficArchive> g_record_archive;
+static std::string g_replay_file;
+static bool g_replay_timing = false;
+
+// Transport for a client under test, honouring --record and --replay
+std::unique_ptr<HttpTransport> make_transport() {
+    if (!g_replay_file.empty()) {
+        auto replay = std::make_unique<ReplayTransport>(g_replay_timing);
+        if (replay->open(g_replay_file)) {
+            std::cout << "Replaying " << replay->exchangeCount() << " exchanges from "
+                      << g_replay_file << std::endl;
+        }
+        return replay;
+    }
+    auto live = std::make_unique<LiveTransport>(g_base_url);
+    if (g_record_archive) {
+        return std::make_unique<RecordingTransport>(std::move(live), g_record_archive);
+    }
+    return live;
+}
+
 void print_separator() {
     std::cout << "=================================================" << std::endl;
 }
@@ -21,6 +52,10 @@ void test_nws_client() {
     
     NWSClient client;
     client.setUserAgent("rpi0-weather-test/1.0");
+    client.setBaseUrl(g_base_url);
+    client.setTransport(make_transport());
+    client.setCompression(g_use_compression);
+    client.setTransferLogging(true);
     
     // Test 1: Get points data
     std::cout << "🔍 Testing NWS Points endpoint..." << std::endl;
@@ -46,7 +81,7 @@ void test_nws_client() {
         std::cout << "✅ Stations endpoint working" << std::endl;
         std::cout << "   Found " << stations.size() << " stations" << std::endl;
         std::cout << "   Closest: " << stations[0].name << " (" << stations[0].id << ")" << std::endl;
-        std::cout << "   Distance²: " << std::fixed << std::setprecision(6) << stations[0].distance_squared << std::endl;
+        std::cout << "   Distance: " << std::fixed << std::setprecision(1) << stations[0].distance_km << " km" << std::endl;
         std::cout << std::endl;
         
         // Test 3: Get observations
@@ -108,6 +143,39 @@ void test_nws_client() {
         }
     }
     
+    // Connection reuse: only the first request should open a socket
+    ConnectionStats conn = client.getConnectionStats();
+    std::cout << std::endl;
+    std::cout << "Connections: " << conn.requests << " requests, "
+              << conn.connections_opened << " opened, "
+              << conn.connections_reused << " reused, "
+              << conn.reconnects << " reconnects" << std::endl;
+    
+    CacheStats cache = client.getCacheStats();
+    std::cout << "Response cache: " << cache.fresh_hits << " fresh hits, "
+              << cache.not_modified << " not modified, "
+              << cache.misses << " misses" << std::endl;
+    
+    TransferStats transfer = client.getTransferStats();
+    std::cout << "Transfer: " << transfer.wire_bytes << " bytes on wire, "
+              << transfer.decoded_bytes << " bytes decoded" << std::endl;
+    
+    ObservationQueryStats obs = client.getObservationQueryStats();
+    std::cout << "Observations: " << obs.queries << " queries, "
+              << obs.latest_hits << " from latest, "
+              << obs.fallbacks << " fallbacks, "
+              << obs.widenings << " widenings, ~"
+              << obs.bytes_saved << " bytes saved" << std::endl;
+    
+    for (const auto& retry : client.getRetryStats()) {
+        std::cout << "Retry " << retry.endpoint << ": " << retry.requests << " requests, "
+                  << retry.retries << " retries, "
+                  << retry.failures << " failures, "
+                  << retry.short_circuited << " short-circuited, "
+                  << retry.stale_served << " stale, breaker "
+                  << circuitStateName(retry.state) << std::endl;
+    }
+    
     print_separator();
     std::cout << "🏁 NWS API test complete" << std::endl;
 }
@@ -118,7 +186,11 @@ void test_weather_service() {
     print_separator();
     
     WeatherService service;
+    service.setBaseUrl(g_base_url);
+    service.setTransport(make_transport());
     service.setLocation(44.1076, -73.9209); // Mount Marcy
+    service.setCompression(g_use_compression);
+    service.setStatsLogging(true);
     
     std::cout << "Fetching complete weather data..." << std::endl;
     WeatherData data = service.fetchWeatherData();
@@ -166,11 +238,71 @@ void test_weather_service() {
     std::cout << "🏁 Weather Service test complete" << std::endl;
 }
 
+void test_multi_location() {
+    std::cout << std::endl;
+    std::cout << "🌍 Testing Multi-Location Service..." << std::endl;
+    print_separator();
+    
+    // Nearby peaks share a forecast grid or station; requests should scale
+    // with the unique grids and stations, not with the location count
+    MultiLocationService service;
+    service.setUserAgent("rpi0-weather-test/1.0");
+    service.setBaseUrl(g_base_url);
+    service.setTransport(make_transport());
+    service.setCompression(g_use_compression);
+    service.addLocation("Mount Marcy", 44.1076, -73.9209);
+    service.addLocation("Mount Marcy summit", 44.1128, -73.9237);
+    service.addLocation("Algonquin Peak", 44.1437, -73.9866);
+    service.addLocation("Lake Placid", 44.2795, -73.9799);
+    
+    for (int pass = 1; pass <= 2; pass++) {
+        bool ok = service.refresh();
+        MultiLocationStats stats = service.getStats();
+        std::cout << (ok ? "✅" : "❌") << " Refresh " << pass << ": "
+                  << stats.locations << " locations, "
+                  << stats.unique_grids << " grids, "
+                  << stats.unique_stations << " stations, "
+                  << stats.http_requests << " HTTP requests" << std::endl;
+    }
+    
+    for (size_t i = 0; i < service.locationCount(); i++) {
+        WeatherData data = service.getWeatherData(i);
+        std::cout << "  " << service.locationName(i) << ": ";
+        if (data.is_valid) {
+            std::cout << data.temperature_f() << "°F, " << data.weather_icon << std::endl;
+        } else {
+            std::cout << data.error_message << std::endl;
+        }
+    }
+    
+    print_separator();
+    std::cout << "🏁 Multi-Location Service test complete" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     bool test_service_only = false;
+    bool test_multi = false;
     
-    if (argc > 1 && std::string(argv[1]) == "--service") {
-        test_service_only = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--service") {
+            test_service_only = true;
+        } else if (arg == "--compress") {
+            g_use_compression = true;
+        } else if (arg == "--base-url" && i + 1 < argc) {
+            g_base_url = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            g_record_archive = TrafficArchive::create(argv[++i]);
+            if (!g_record_archive) {
+                return 1;
+            }
+        } else if (arg == "--replay" && i + 1 < argc) {
+            g_replay_file = argv[++i];
+        } else if (arg == "--replay-timing") {
+            g_replay_timing = true;
+        } else if (arg == "--multi") {
+            test_multi = true;
+        }
     }
     
     if (!test_service_only) {
@@ -179,5 +311,9 @@ int main(int argc, char* argv[]) {
     
     test_weather_service();
     
+    if (test_multi) {
+        test_multi_location();
+    }
+    
     return 0;
 }
\ No newline at end of file
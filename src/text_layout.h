@@ -0,0 +1,97 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <string>
+#include <cstdint>
+
+// Text code shared by the renderers. It is templated on the Font descriptor
+// that font_converter emits into each generated header (for example
+// font_Inter_Regular_24::Font), so every font gets its own inlined path:
+//   Font::Glyph              x, y, w, h, xoff, yoff, advance
+//   Font::size, line_height, baseline, atlas_width, atlas_height
+//   Font::atlas()            8-bit coverage atlas
+//   Font::glyph(codepoint)   glyph, or the font's fallback; nullptr if neither
+
+// Decode the UTF-8 sequence at text[i] and advance i past it. Invalid and
+// truncated sequences are skipped a byte at a time; false at the end.
+inline bool next_codepoint(const std::string& text, size_t& i, uint32_t& codepoint) {
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1
+                      : (lead & 0xE0) == 0xC0 ? 2
+                      : (lead & 0xF0) == 0xE0 ? 3
+                      : (lead & 0xF8) == 0xF0 ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            i++;
+            continue;
+        }
+
+        uint32_t value = length == 1 ? lead : (lead & (0x7F >> length));
+        bool valid = true;
+        for (size_t k = 1; k < length; k++) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            value = (value << 6) | (next & 0x3F);
+        }
+        if (!valid) {
+            i++;
+            continue;
+        }
+
+        i += length;
+        codepoint = value;
+        return true;
+    }
+    return false;
+}
+
+// Call fn(const Font::Glyph*) for each character of text in order; the
+// pointer is nullptr only when the font has no fallback glyph
+template <typename Font, typename Fn>
+void for_each_glyph(const std::string& text, Fn&& fn) {
+    size_t i = 0;
+    uint32_t codepoint;
+    while (next_codepoint(text, i, codepoint)) {
+        fn(Font::glyph(codepoint));
+    }
+}
+
+// Blit one glyph's coverage above threshold as horizontal runs.
+// clip(x, y, w, h) narrows a box to the drawable area and returns false if
+// nothing is left; span(x, y, length) writes one run.
+template <typename Font, typename Clip, typename Span>
+void blit_glyph(const typename Font::Glyph& glyph, int pen_x, int pen_y, Clip&& clip, Span&& span) {
+    constexpr uint8_t ALPHA_THRESHOLD = 128;
+
+    int x = pen_x + glyph.xoff;
+    int y = pen_y + glyph.yoff;
+    int w = glyph.w;
+    int h = glyph.h;
+    if (w <= 0 || h <= 0 || !clip(x, y, w, h)) {
+        return;
+    }
+
+    int skip_x = x - (pen_x + glyph.xoff);
+    int skip_y = y - (pen_y + glyph.yoff);
+    for (int gy = 0; gy < h; gy++) {
+        const uint8_t* alpha = Font::atlas() + (glyph.y + skip_y + gy) * Font::atlas_width + glyph.x + skip_x;
+        int gx = 0;
+        while (gx < w) {
+            if (alpha[gx] <= ALPHA_THRESHOLD) {
+                gx++;
+                continue;
+            }
+            int run = 1;
+            while (gx + run < w && alpha[gx + run] > ALPHA_THRESHOLD) {
+                run++;
+            }
+            span(x + gx, y + gy, run);
+            gx += run;
+        }
+    }
+}
+
+#endif // TEXT_LAYOUT_H
@@ -0,0 +1,280 @@
+#include "traffic_archive.h"
+#include "binary_io.h"
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+constexpr char MAGIC[4] = {'N', 'W', 'S', 'T'};
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint16_t);
+
+// Replayed bodies are handed over in chunks, as a socket would
+constexpr size_t REPLAY_CHUNK_SIZE = 16 * 1024;
+
+uint32_t millisecondsSince(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+} // namespace
+
+TrafficArchive::TrafficArchive(const std::string& path, FILE* file)
+    : path_(path)
+    , file_(file)
+{
+}
+
+TrafficArchive::~TrafficArchive() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+std::shared_ptr<TrafficArchive> TrafficArchive::create(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file) {
+        std::cerr << "Could not open traffic archive: " << path << std::endl;
+        return nullptr;
+    }
+    
+    if (std::ftell(file) == 0) {
+        BinaryWriter header;
+        header.bytes.insert(header.bytes.end(), MAGIC, MAGIC + sizeof(MAGIC));
+        header.u16(FORMAT_VERSION);
+        if (std::fwrite(header.bytes.data(), 1, header.bytes.size(), file) != header.bytes.size()) {
+            std::cerr << "Could not write traffic archive: " << path << std::endl;
+            std::fclose(file);
+            return nullptr;
+        }
+    }
+    
+    return std::shared_ptr<TrafficArchive>(new TrafficArchive(path, file));
+}
+
+bool TrafficArchive::append(const TrafficExchange& exchange) {
+    BinaryWriter payload;
+    payload.str(exchange.path);
+    payload.i32(exchange.status);
+    payload.str(exchange.reason);
+    payload.u16(static_cast<uint16_t>(std::min<size_t>(exchange.headers.size(), UINT16_MAX)));
+    for (size_t i = 0; i < exchange.headers.size() && i < UINT16_MAX; i++) {
+        payload.str(exchange.headers[i].first);
+        payload.str(exchange.headers[i].second);
+    }
+    payload.u32(exchange.first_byte_ms);
+    payload.u32(exchange.total_ms);
+    payload.blob(exchange.body);
+    
+    BinaryWriter frame;
+    frame.u32(static_cast<uint32_t>(payload.bytes.size()));
+    frame.bytes.insert(frame.bytes.end(), payload.bytes.begin(), payload.bytes.end());
+    frame.u32(fnv1a(payload.bytes.data(), payload.bytes.size()));
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool ok = std::fwrite(frame.bytes.data(), 1, frame.bytes.size(), file_) == frame.bytes.size();
+    ok = std::fflush(file_) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Could not write traffic archive: " << path_ << std::endl;
+    }
+    return ok;
+}
+
+bool TrafficArchive::load(const std::string& path, std::vector<TrafficExchange>& exchanges) {
+    exchanges.clear();
+    
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Could not open traffic archive: " << path << std::endl;
+        return false;
+    }
+    
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[64 * 1024];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+    
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Not a traffic archive: " << path << std::endl;
+        return false;
+    }
+    
+    BinaryReader header(bytes.data() + sizeof(MAGIC), sizeof(uint16_t));
+    uint16_t version = header.u16();
+    if (version != FORMAT_VERSION) {
+        std::cerr << "Unsupported traffic archive version " << version << ": " << path << std::endl;
+        return false;
+    }
+    
+    size_t offset = HEADER_SIZE;
+    while (offset < bytes.size()) {
+        BinaryReader length(bytes.data() + offset, bytes.size() - offset);
+        uint32_t payload_size = length.u32();
+        size_t payload_start = offset + sizeof(uint32_t);
+        if (!length.ok() || payload_start + payload_size + sizeof(uint32_t) > bytes.size()) {
+            std::cerr << "Ignoring truncated record at end of " << path << std::endl;
+            break;
+        }
+        
+        const uint8_t* payload_data = bytes.data() + payload_start;
+        BinaryReader checksum(payload_data + payload_size, sizeof(uint32_t));
+        if (checksum.u32() != fnv1a(payload_data, payload_size)) {
+            std::cerr << "Ignoring corrupt record in " << path << std::endl;
+            break;
+        }
+        
+        BinaryReader payload(payload_data, payload_size);
+        TrafficExchange exchange;
+        exchange.path = payload.str();
+        exchange.status = payload.i32();
+        exchange.reason = payload.str();
+        uint16_t header_count = payload.u16();
+        for (uint16_t i = 0; i < header_count && payload.ok(); i++) {
+            std::string name = payload.str();
+            std::string value = payload.str();
+            exchange.headers.emplace_back(std::move(name), std::move(value));
+        }
+        exchange.first_byte_ms = payload.u32();
+        exchange.total_ms = payload.u32();
+        exchange.body = payload.blob();
+        if (!payload.ok()) {
+            std::cerr << "Ignoring malformed record in " << path << std::endl;
+            break;
+        }
+        exchanges.push_back(std::move(exchange));
+        offset = payload_start + payload_size + sizeof(uint32_t);
+    }
+    return true;
+}
+
+RecordingTransport::RecordingTransport(std::unique_ptr<HttpTransport> inner,
+                                       std::shared_ptr<TrafficArchive> archive)
+    : inner_(std::move(inner))
+    , archive_(std::move(archive))
+{
+}
+
+bool RecordingTransport::get(const std::string& path, const Headers& headers,
+                             const ResponseHandler& on_response, const ContentHandler& on_content,
+                             TransportResponse& response, std::string& error) {
+    TrafficExchange exchange;
+    exchange.path = path;
+    auto start = std::chrono::steady_clock::now();
+    bool aborted = false;
+    
+    auto record_response = [&](const TransportResponse& res) {
+        exchange.first_byte_ms = millisecondsSince(start);
+        exchange.headers = res.headers;
+        exchange.body.clear();
+        aborted = !on_response(res);
+        return !aborted;
+    };
+    auto record_content = [&](const char* data, size_t length) {
+        exchange.body.append(data, length);
+        aborted = !on_content(data, length);
+        return !aborted;
+    };
+    
+    bool ok = inner_->get(path, headers, record_response, record_content, response, error);
+    exchange.total_ms = millisecondsSince(start);
+    
+    // The caller stopped the download (cancelled, or over its size cap);
+    // the server answered normally, so this is not a failure to replay
+    if (!ok && aborted) {
+        return false;
+    }
+    
+    if (ok) {
+        exchange.status = response.status;
+        exchange.reason = response.reason;
+    } else {
+        exchange.status = 0;
+        exchange.reason = error;
+        exchange.headers.clear();
+        exchange.body.clear();
+    }
+    archive_->append(exchange);
+    return ok;
+}
+
+ReplayTransport::ReplayTransport(bool replay_timing)
+    : replay_timing_(replay_timing)
+    , exchange_count_(0)
+{
+}
+
+bool ReplayTransport::open(const std::string& archive_path) {
+    std::vector<TrafficExchange> exchanges;
+    if (!TrafficArchive::load(archive_path, exchanges)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    recordings_.clear();
+    for (auto& exchange : exchanges) {
+        std::string path = exchange.path;
+        recordings_[path].exchanges.push_back(std::move(exchange));
+    }
+    exchange_count_ = exchanges.size();
+    return true;
+}
+
+bool ReplayTransport::get(const std::string& path, const Headers&,
+                          const ResponseHandler& on_response, const ContentHandler& on_content,
+                          TransportResponse& response, std::string& error) {
+    const TrafficExchange* exchange = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = recordings_.find(path);
+        if (it == recordings_.end()) {
+            error = "No recorded response for " + path;
+            return false;
+        }
+        Recording& recording = it->second;
+        exchange = &recording.exchanges[recording.next];
+        if (recording.next + 1 < recording.exchanges.size()) {
+            recording.next++;
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    if (replay_timing_) {
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(exchange->first_byte_ms));
+    }
+    
+    if (exchange->status == 0) {
+        error = exchange->reason;
+        return false;
+    }
+    
+    response.status = exchange->status;
+    response.reason = exchange->reason;
+    response.headers = exchange->headers;
+    if (!on_response(response)) {
+        error = "Canceled";
+        return false;
+    }
+    
+    // Spread the body over the recorded transfer time when replaying timings
+    const std::string& body = exchange->body;
+    uint32_t transfer_ms = exchange->total_ms > exchange->first_byte_ms
+                         ? exchange->total_ms - exchange->first_byte_ms : 0;
+    for (size_t offset = 0; offset < body.size(); offset += REPLAY_CHUNK_SIZE) {
+        size_t length = std::min(REPLAY_CHUNK_SIZE, body.size() - offset);
+        if (replay_timing_ && transfer_ms > 0) {
+            auto due = std::chrono::milliseconds(exchange->first_byte_ms +
+                                                 transfer_ms * (offset + length) / body.size());
+            std::this_thread::sleep_until(start + due);
+        }
+        if (!on_content(body.data() + offset, length)) {
+            error = "Canceled";
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+#ifndef TRAFFIC_ARCHIVE_H
+#define TRAFFIC_ARCHIVE_H
+
+#include "http_transport.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+/**
+ * One recorded GET: the response as it came off the wire (body still
+ * content-encoded) plus its timings. Status 0 records a network failure,
+ * with the error in reason.
+ */
+struct TrafficExchange {
+    std::string path;
+    int status = 0;
+    std::string reason;
+    std::vector<std::pair<std::string, std::string>> headers;
+    uint32_t first_byte_ms = 0;  // Request sent to headers received
+    uint32_t total_ms = 0;       // Request sent to last body byte
+    std::string body;
+};
+
+/**
+ * Append-only archive of recorded exchanges.
+ *
+ * Layout: "NWST" magic and format version, then one frame per exchange:
+ * payload length, payload, FNV-1a checksum of the payload. Frames are
+ * flushed as they are written, so an interrupted recording keeps every
+ * exchange that completed.
+ */
+class TrafficArchive {
+public:
+    static constexpr uint16_t FORMAT_VERSION = 1;
+
+    // Open path for appending; a new or empty file gets the header first
+    static std::shared_ptr<TrafficArchive> create(const std::string& path);
+    ~TrafficArchive();
+
+    bool append(const TrafficExchange& exchange);
+    const std::string& path() const { return path_; }
+
+    // Every intact exchange in the file, in recording order; empty and
+    // false if the file is missing or not an archive
+    static bool load(const std::string& path, std::vector<TrafficExchange>& exchanges);
+
+private:
+    TrafficArchive(const std::string& path, FILE* file);
+
+    std::string path_;
+    FILE* file_;
+    std::mutex mutex_;
+};
+
+/**
+ * Passes requests through to another transport and appends every
+ * exchange to an archive. Several transports may share one archive.
+ */
+class RecordingTransport : public HttpTransport {
+public:
+    RecordingTransport(std::unique_ptr<HttpTransport> inner, std::shared_ptr<TrafficArchive> archive);
+
+    bool get(const std::string& path, const Headers& headers,
+             const ResponseHandler& on_response, const ContentHandler& on_content,
+             TransportResponse& response, std::string& error) override;
+
+    void setTimeout(int timeout_seconds) override { inner_->setTimeout(timeout_seconds); }
+    ConnectionStats getConnectionStats() const override { return inner_->getConnectionStats(); }
+
+private:
+    std::unique_ptr<HttpTransport> inner_;
+    std::shared_ptr<TrafficArchive> archive_;
+};
+
+/**
+ * Serves recorded exchanges without touching the network. Repeated
+ * requests for a path get its recordings in order, then the last one
+ * again. Optionally sleeps to reproduce the original timings.
+ */
+class ReplayTransport : public HttpTransport {
+public:
+    explicit ReplayTransport(bool replay_timing = false);
+
+    bool open(const std::string& archive_path);
+    size_t exchangeCount() const { return exchange_count_; }
+
+    bool get(const std::string& path, const Headers& headers,
+             const ResponseHandler& on_response, const ContentHandler& on_content,
+             TransportResponse& response, std::string& error) override;
+
+private:
+    struct Recording {
+        std::vector<TrafficExchange> exchanges;
+        size_t next = 0;
+    };
+
+    bool replay_timing_;
+    size_t exchange_count_;
+    std::mutex mutex_;
+    std::map<std::string, Recording> recordings_;
+};
+
+#endif // TRAFFIC_ARCHIVE_H
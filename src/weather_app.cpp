@@ -1,5 +1,6 @@
 #include "weather_app.h"
 #include "weather_icons_large.h"
+#include "weather_snapshot.h"
 #include "logger.h"
 
 // For PNG output in renderAllIconsTest
@@ -37,12 +38,13 @@ WeatherApp::WeatherApp()
     , inky_display_(nullptr)
     , use_sdl_emulator_(true)
     , use_real_api_(false)
+    , location_index_(0)
     , initialized_(false)
     , debug_enabled_(false)
-    , update_in_progress_(false) 
 {
     weather_service_ = std::make_unique<WeatherService>();
     renderer_ = std::make_unique<DisplayRenderer>();
+    fetch_worker_ = std::make_unique<FetchWorker>([this]() { return fetch_weather_data(); });
 }
 
 WeatherApp::~WeatherApp() {
@@ -73,9 +75,50 @@ bool WeatherApp::initialize(const std::string& config_file, bool debug) {
     use_sdl_emulator_ = config_.use_sdl_emulator;
     use_real_api_ = config_.use_real_api;
     
+    FreshnessPolicy freshness;
+    freshness.observation_ttl = std::chrono::minutes(config_.observation_ttl_minutes);
+    freshness.gridpoint_ttl = std::chrono::minutes(config_.forecast_ttl_minutes);
+    freshness.forecast_ttl = std::chrono::minutes(config_.forecast_ttl_minutes);
+    freshness.hourly_ttl = std::chrono::minutes(config_.forecast_ttl_minutes);
+    
+    // Several locations share one client through MultiLocationService
+    if (use_real_api_ && !config_.locations.empty()) {
+        multi_service_ = std::make_unique<MultiLocationService>();
+        multi_service_->setBaseUrl(config_.api_base_url);
+        multi_service_->setCompression(config_.compressed_transfer);
+        multi_service_->setEndpointCacheFile(config_.endpoint_cache_file);
+        multi_service_->setEndpointRevalidateInterval(config_.endpoint_revalidate_hours);
+        multi_service_->setHourlyForecast(config_.hourly_forecast);
+        multi_service_->setTransferLogging(debug_enabled_);
+        multi_service_->setStatsLogging(debug_enabled_);
+        multi_service_->setMaxResponseBytes(static_cast<size_t>(config_.max_response_kb) * 1024);
+        multi_service_->setFreshnessPolicy(freshness);
+        for (const auto& location : config_.locations) {
+            multi_service_->addLocation(location.name, location.latitude, location.longitude);
+        }
+        std::cout << "Serving " << config_.locations.size() << " locations" << std::endl;
+    }
+    
     // Set location in weather service
     if (weather_service_ && use_real_api_) {
+        weather_service_->setBaseUrl(config_.api_base_url);
         weather_service_->setLocation(config_.latitude, config_.longitude);
+        weather_service_->setCompression(config_.compressed_transfer);
+        weather_service_->setEndpointCacheFile(config_.endpoint_cache_file);
+        weather_service_->setEndpointRevalidateInterval(config_.endpoint_revalidate_hours);
+        weather_service_->setHourlyForecast(config_.hourly_forecast);
+        weather_service_->setTransferLogging(debug_enabled_);
+        weather_service_->setStatsLogging(debug_enabled_);
+        weather_service_->setMaxResponseBytes(static_cast<size_t>(config_.max_response_kb) * 1024);
+        weather_service_->setFreshnessPolicy(freshness);
+        
+        if (!config_.snapshot_file.empty()) {
+            auto snapshot = WeatherSnapshot::load(config_.snapshot_file);
+            if (snapshot.has_value()) {
+                last_good_data_ = snapshot.value();
+                std::cout << "Loaded last known weather from " << config_.snapshot_file << std::endl;
+            }
+        }
     }
     
     // Initialize Inky display if not using SDL emulator
@@ -125,52 +168,45 @@ bool WeatherApp::initialize(const std::string& config_file, bool debug) {
 }
 
 void WeatherApp::update() {
-    if (!initialized_ || update_in_progress_) {
+    if (!initialized_) {
         return;
     }
     
-    // Set flag to prevent concurrent updates
-    update_in_progress_ = true;
-    
-    // Get weather data
-    WeatherData data;
-    if (use_real_api_ && weather_service_) {
-        std::cout << "Fetching weather data from NWS API..." << std::endl;
-        data = weather_service_->fetchWeatherData();
-    } else {
-        data = create_mock_weather_data();
+    // The result reaches the display through takeResult() in run()
+    bool coalesced = false;
+    fetch_worker_->requestFetch(&coalesced);
+    if (coalesced) {
+        FetchWorkerStats stats = fetch_worker_->getStats();
+        std::cout << "Weather update already in progress, joined it ("
+                  << stats.coalesced << " requests coalesced)" << std::endl;
     }
-    
+}
+
+void WeatherApp::display_weather(const WeatherData& data) {
     if (!data.is_valid) {
-        std::cerr << "Invalid weather data: " << data.error_message << std::endl;
-        // Try to use mock data as fallback
-        if (use_real_api_) {
-            std::cout << "Falling back to mock data" << std::endl;
-            data = create_mock_weather_data();
-        }
-        if (!data.is_valid) {
-            update_in_progress_ = false;  // Clear flag on error
-            return;
-        }
+        return;
     }
     
     // Render weather data to unified backbuffer
     render_weather(data);
     
-    // Present to all target devices
-    renderer_->present();
+    // Present to all target devices; a frame identical to the one on the
+    // panel is not refreshed again
+    if (!renderer_->present()) {
+        Logger::getInstance().logInfo("Weather unchanged, display refresh skipped");
+        last_update_ = std::chrono::steady_clock::now();
+        return;
+    }
     
     // Log the display update
     Logger::getInstance().logDisplayUpdate(
-        config_.location_name,
+        multi_service_ ? data.location : config_.location_name,
         static_cast<int>(data.temperature_c * 9.0 / 5.0 + 32),  // Convert C to F for logging
         data.weather_description,
-        use_real_api_ ? "NWS" : "MOCK"
+        !use_real_api_ ? "MOCK" : (data.is_stale ? "SNAPSHOT" : "NWS")
     );
     
-    // Update timestamp and clear flag
     last_update_ = std::chrono::steady_clock::now();
-    update_in_progress_ = false;
 }
 
 void WeatherApp::run() {
@@ -181,9 +217,24 @@ void WeatherApp::run() {
     
     std::cout << "Weather app initialized. Starting main loop..." << std::endl;
     
-    // Initial update on launch
+    // Taken before the worker starts; from then on the worker owns last_good_data_
+    WeatherData boot_data = last_good_data_;
+    
+    // Network I/O happens on the worker so events and buttons stay responsive
+    fetch_worker_->start();
+    
+    // Initial update on launch, started before the boot frame so the fetch
+    // runs during its e-ink refresh
     update();
     
+    // Show the last known weather straight away so the first frame does not
+    // wait on the network
+    if (use_real_api_ && boot_data.is_valid) {
+        std::cout << "Rendering last known weather while fetching" << std::endl;
+        render_weather(boot_data);
+        renderer_->present();
+    }
+    
     // Calculate next aligned update time (10, 20, 30, 40, 50, or 00 minutes past the hour)
     auto next_update = getNextUpdateTime();
     
@@ -195,6 +246,11 @@ void WeatherApp::run() {
         // Poll hardware buttons
         inky_button_poll();
         
+        // Show a fetch as soon as the worker has finished it
+        if (auto data = fetch_worker_->takeResult()) {
+            display_weather(*data);
+        }
+        
         // Check if it's time for scheduled update
         auto now = std::chrono::system_clock::now();
         if (now >= next_update) {
@@ -202,11 +258,12 @@ void WeatherApp::run() {
             if (!shouldSkipUpdate(next_update)) {
                 // Get the minute for logging
                 auto update_time_t = std::chrono::system_clock::to_time_t(next_update);
-                std::tm* update_tm = std::localtime(&update_time_t);
+                std::tm update_tm = {};
+                localtime_r(&update_time_t, &update_tm);
                 
                 std::cout << "Scheduled weather update at " 
-                          << std::setfill('0') << std::setw(2) << update_tm->tm_hour << ":"
-                          << std::setfill('0') << std::setw(2) << update_tm->tm_min 
+                          << std::setfill('0') << std::setw(2) << update_tm.tm_hour << ":"
+                          << std::setfill('0') << std::setw(2) << update_tm.tm_min 
                           << std::endl;
                 Logger::getInstance().logInfo("Scheduled weather update");
                 update();
@@ -230,6 +287,9 @@ void WeatherApp::shutdown() {
         return;
     }
     
+    // Let an in-flight fetch finish before tearing anything down
+    fetch_worker_->stop();
+    
     // Clean up button resources
     inky_button_cleanup();
     g_weather_app_instance = nullptr;
@@ -263,25 +323,9 @@ bool WeatherApp::renderTestFrame(const std::string& output_file) {
     }
     
     // Get weather data
-    WeatherData data;
-    if (use_real_api_ && weather_service_) {
-        std::cout << "Fetching weather data from NWS API..." << std::endl;
-        data = weather_service_->fetchWeatherData();
-    } else {
-        std::cout << "Using mock weather data" << std::endl;
-        data = create_mock_weather_data();
-    }
-    
+    WeatherData data = fetch_weather_data();
     if (!data.is_valid) {
-        std::cerr << "Invalid weather data: " << data.error_message << std::endl;
-        // Try to use mock data as fallback
-        if (use_real_api_) {
-            std::cout << "Falling back to mock data" << std::endl;
-            data = create_mock_weather_data();
-        }
-        if (!data.is_valid) {
-            return false;
-        }
+        return false;
     }
     
     // Render to unified backbuffer
@@ -291,6 +335,48 @@ bool WeatherApp::renderTestFrame(const std::string& output_file) {
     return renderer_->save_png(output_file);
 }
 
+WeatherData WeatherApp::fetch_weather_data() {
+    if (!use_real_api_ || !weather_service_) {
+        std::cout << "Using mock weather data" << std::endl;
+        return create_mock_weather_data();
+    }
+    
+    std::cout << "Fetching weather data from NWS API..." << std::endl;
+    WeatherData data;
+    std::string location;
+    if (multi_service_) {
+        multi_service_->refresh();
+        size_t index = location_index_.load();
+        data = multi_service_->getWeatherData(index);
+        location = multi_service_->locationName(index);
+    } else {
+        data = weather_service_->fetchWeatherData();
+    }
+    
+    if (data.is_valid) {
+        // Only rewrite the snapshot when the data actually changed; data
+        // the service already marked stale is not worth keeping
+        if (!data.is_stale && (data.timestamp != last_good_data_.timestamp || last_good_data_.is_stale)) {
+            last_good_data_ = data;
+            if (!config_.snapshot_file.empty()) {
+                WeatherSnapshot::save(config_.snapshot_file, data);
+            }
+        }
+        return data;
+    }
+    
+    std::cerr << "Invalid weather data: " << data.error_message << std::endl;
+    // Another location's data is no stand-in for the one on display
+    if (last_good_data_.is_valid && (location.empty() || last_good_data_.location == location)) {
+        std::cout << "Showing last known weather from " << std::ctime(&last_good_data_.timestamp);
+        WeatherData stale = last_good_data_;
+        stale.is_stale = true;
+        return stale;
+    }
+    
+    return data;
+}
+
 void WeatherApp::render_weather(const WeatherData& data) {
     // Clear display to white
     renderer_->clear(DisplayRenderer::WHITE);
@@ -382,10 +468,19 @@ void WeatherApp::render_weather(const WeatherData& data) {
     renderer_->draw_text_centered(PANELS[5].x, values_start_y, PANEL_WIDTH, MEDIUM_VALUE_HEIGHT, humidity_str, DisplayRenderer::BLACK);
     renderer_->draw_text_centered(PANELS[5].x, values_start_y + MEDIUM_VALUE_HEIGHT + VALUE_GAP, PANEL_WIDTH, MEDIUM_VALUE_HEIGHT, dew_str, DisplayRenderer::BLACK);
     
-    // Add timestamp at bottom
-    auto now = std::time(nullptr);
-    auto tm = *std::localtime(&now);
+    // Add timestamp at bottom. It is the time the data last changed, not the
+    // wall clock, so a fetch that brings nothing new renders the same frame
+    // and present() can skip the e-ink refresh. Mock data carries no time.
     std::ostringstream oss;
+    std::time_t shown = data.timestamp != 0 ? data.timestamp : std::time(nullptr);
+    std::tm tm = {};
+    localtime_r(&shown, &tm);
+    if (multi_service_) {
+        oss << data.location << "  ";
+    }
+    if (data.is_stale) {
+        oss << "Stale: ";
+    }
     oss << std::put_time(&tm, "%m/%d/%Y %I:%M%p");
     int date_y = BORDER_WIDTH * 3 + PANEL_HEIGHT * 2;
     int date_h = SCREEN_HEIGHT - date_y - BORDER_WIDTH;
@@ -530,25 +625,42 @@ bool WeatherApp::renderAllIconsTest(const std::string& output_file) {
     return result != 0;
 }
 
+void WeatherApp::show_next_location() {
+    size_t count = multi_service_->locationCount();
+    size_t index = (location_index_.load() + 1) % count;
+    location_index_ = index;
+    
+    std::cout << "Showing " << multi_service_->locationName(index) << std::endl;
+    WeatherData data = multi_service_->getWeatherData(index);
+    if (data.is_valid) {
+        display_weather(data);
+    } else {
+        // Not fetched yet, or its last refresh failed
+        update();
+    }
+}
+
 void WeatherApp::on_button_pressed(int button) {
-    // Any button press triggers a weather update (if not already updating)
     char button_char = 'A' + button;
+    Logger::getInstance().logButtonPress(button_char);
     
-    if (update_in_progress_) {
-        std::cout << "Button " << button_char << " pressed - update already in progress, ignoring" << std::endl;
-        Logger::getInstance().logInfo("Button " + std::string(1, button_char) + " pressed - ignored (update in progress)");
+    // With several locations, C cycles through them
+    if (button_char == 'C' && multi_service_ && multi_service_->locationCount() > 1) {
+        show_next_location();
         return;
     }
     
+    // Any other button press triggers a weather update; one already in
+    // flight is joined rather than started again
     std::cout << "Button " << button_char << " pressed - updating weather..." << std::endl;
-    Logger::getInstance().logButtonPress(button_char);
     update();
 }
 
 std::chrono::system_clock::time_point WeatherApp::getNextUpdateTime() {
     auto now = std::chrono::system_clock::now();
     auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm now_tm = *std::localtime(&now_time_t);  // Make a copy
+    std::tm now_tm = {};
+    localtime_r(&now_time_t, &now_tm);
     
     // Calculate minutes to next 10-minute interval
     int current_minutes = now_tm.tm_min;
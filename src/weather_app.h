@@ -2,9 +2,12 @@
 
 #include "weather_data.h"
 #include "weather_service.h"
+#include "multi_location_service.h"
+#include "fetch_worker.h"
 #include "display_renderer.h"
 #include "config.h"
 #include <memory>
+#include <atomic>
 #include <chrono>
 
 // Forward declarations
@@ -22,7 +25,8 @@ public:
     // Initialize the display with optional config file and debug flag
     bool initialize(const std::string& config_file = "config.json", bool debug = false);
     
-    // Update weather data and refresh display
+    // Start a background weather fetch; the display refreshes once the
+    // main loop picks up the result
     void update();
     
     // Run the main event loop
@@ -50,6 +54,18 @@ private:
     // Simplified unified rendering function
     void render_weather(const WeatherData& data);
     
+    // Render and present a finished fetch, then log it
+    void display_weather(const WeatherData& data);
+    
+    // Switch the display to the next configured location, showing its data
+    // from the last refresh straight away
+    void show_next_location();
+    
+    // Fetch live (or mock) data. A successful live fetch is snapshotted to
+    // disk; a failed one falls back to the last known good data, marked stale.
+    // Runs on the fetch worker thread once the main loop has started.
+    WeatherData fetch_weather_data();
+    
     // Display constants
     static constexpr int SCREEN_WIDTH = 600;
     static constexpr int SCREEN_HEIGHT = 448;
@@ -91,12 +107,23 @@ private:
     // Weather service for API calls
     std::unique_ptr<WeatherService> weather_service_;
     
+    // Used instead of weather_service_ when config lists several locations;
+    // every refresh fetches all of them and the display shows one
+    std::unique_ptr<MultiLocationService> multi_service_;
+    std::atomic<size_t> location_index_;
+    
+    // Runs fetch_weather_data off the main loop
+    std::unique_ptr<FetchWorker> fetch_worker_;
+    
     // Configuration
     Config config_;
     
     bool initialized_;
     bool debug_enabled_;
-    bool update_in_progress_;
+    
+    // Last successful live fetch, restored from the snapshot file at boot.
+    // Owned by the fetch worker while the main loop runs.
+    WeatherData last_good_data_;
     
     // Timer for weather updates
     std::chrono::steady_clock::time_point last_update_;
@@ -0,0 +1,297 @@
+#include "weather_condition.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+// Phenomena named in a weather code
+enum WeatherFlag : uint8_t {
+    WX_FOG = 1 << 0,
+    WX_BLOWING = 1 << 1,
+    WX_THUNDER = 1 << 2,
+    WX_RAIN = 1 << 3,
+    WX_SNOW = 1 << 4,
+    WX_FREEZING = 1 << 5,
+    WX_HAIL = 1 << 6,
+    WX_SLEET = 1 << 7
+};
+
+struct CodeEntry {
+    std::string_view code;
+    uint8_t flags;
+};
+
+// NWS gridpoint weather codes, sorted for binary search
+constexpr CodeEntry WEATHER_CODES[] = {
+    {"blowing_dust", WX_BLOWING},
+    {"blowing_sand", WX_BLOWING},
+    {"blowing_snow", WX_BLOWING | WX_SNOW},
+    {"drizzle", WX_RAIN},
+    {"fog", WX_FOG},
+    {"freezing_drizzle", WX_FREEZING | WX_RAIN},
+    {"freezing_fog", WX_FREEZING | WX_FOG},
+    {"freezing_rain", WX_FREEZING | WX_RAIN},
+    {"freezing_spray", WX_FREEZING},
+    {"frost", 0},
+    {"hail", WX_HAIL},
+    {"haze", 0},
+    {"ice_crystals", 0},
+    {"ice_fog", WX_FOG},
+    {"rain", WX_RAIN},
+    {"rain_showers", WX_RAIN},
+    {"sleet", WX_SLEET},
+    {"smoke", 0},
+    {"snow", WX_SNOW},
+    {"snow_showers", WX_SNOW},
+    {"thunderstorms", WX_THUNDER},
+    {"volcanic_ash", 0},
+    {"water_spouts", 0}
+};
+
+constexpr bool isSorted(const CodeEntry* entries, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        if (!(entries[i - 1].code < entries[i].code)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isSorted(WEATHER_CODES, std::size(WEATHER_CODES)), "WEATHER_CODES must be sorted");
+
+struct Keyword {
+    std::string_view word;
+    uint8_t flags;
+};
+
+// Fallback for free text and codes missing from the table
+constexpr Keyword KEYWORDS[] = {
+    {"fog", WX_FOG},
+    {"blowing", WX_BLOWING},
+    {"wind", WX_BLOWING},
+    {"thunder", WX_THUNDER},
+    {"rain", WX_RAIN},
+    {"drizzle", WX_RAIN},
+    {"shower", WX_RAIN},
+    {"snow", WX_SNOW},
+    {"freezing", WX_FREEZING},
+    {"hail", WX_HAIL},
+    {"sleet", WX_SLEET}
+};
+
+bool containsNoCase(std::string_view text, std::string_view word) {
+    auto it = std::search(text.begin(), text.end(), word.begin(), word.end(),
+                          [](char a, char b) {
+                              return std::tolower(static_cast<unsigned char>(a)) == b;
+                          });
+    return it != text.end();
+}
+
+uint8_t weatherFlags(std::string_view weather) {
+    auto it = std::lower_bound(std::begin(WEATHER_CODES), std::end(WEATHER_CODES), weather,
+                               [](const CodeEntry& entry, std::string_view code) {
+                                   return entry.code < code;
+                               });
+    if (it != std::end(WEATHER_CODES) && it->code == weather) {
+        return it->flags;
+    }
+    
+    uint8_t flags = 0;
+    for (const auto& keyword : KEYWORDS) {
+        if (containsNoCase(weather, keyword.word)) {
+            flags |= keyword.flags;
+        }
+    }
+    return flags;
+}
+
+// Icon selection rules; evaluated for every key at compile time
+constexpr uint8_t selectIcon(Condition condition, Intensity intensity, bool day, SkyCover sky, bool hot) {
+    bool light = intensity == Intensity::Light;
+    bool moderate = intensity == Intensity::Moderate;
+    
+    switch (condition) {
+        case Condition::Hail:
+            return 4;                               // Hail storm
+        case Condition::Thunder:
+            return light ? (day ? 3 : 38) : 17;     // Light thunderstorm day/night, or heavy
+        case Condition::RainSnow:
+            return 5;                               // Rain/snow mix
+        case Condition::FreezingRain:
+            return intensity == Intensity::Heavy ? 2 : 1;
+        case Condition::Fog:
+            return (light && day) ? 18 : 20;
+        case Condition::Snow:
+            return light ? (day ? 14 : 46) : (moderate ? 13 : 12);
+        case Condition::Rain:
+            return light ? (day ? 9 : 45) : (moderate ? 10 : 0);
+        case Condition::Blowing:
+            return 23;                              // Windy
+        default:
+            break;
+    }
+    
+    // Clear or cloudy conditions based on sky cover
+    switch (sky) {
+        case SkyCover::Overcast: return 16;
+        case SkyCover::Mostly: return day ? 26 : 31;
+        case SkyCover::Partly: return day ? 28 : 27;
+        case SkyCover::Few: return day ? 30 : 29;
+        default: return day ? (hot ? 22 : 19) : 21;  // Hot sun, clear day, moon
+    }
+}
+
+constexpr std::array<uint8_t, ICON_KEY_COUNT> buildIconTable() {
+    std::array<uint8_t, ICON_KEY_COUNT> table{};
+    size_t index = 0;
+    for (size_t c = 0; c < static_cast<size_t>(Condition::Count); c++) {
+        for (size_t i = 0; i < static_cast<size_t>(Intensity::Count); i++) {
+            for (int day = 0; day < 2; day++) {
+                for (size_t s = 0; s < static_cast<size_t>(SkyCover::Count); s++) {
+                    for (int hot = 0; hot < 2; hot++) {
+                        table[index++] = selectIcon(static_cast<Condition>(c), static_cast<Intensity>(i),
+                                                    day != 0, static_cast<SkyCover>(s), hot != 0);
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, ICON_KEY_COUNT> ICON_TABLE = buildIconTable();
+
+constexpr int ICON_COUNT = 48;
+
+constexpr char ICON_NAMES[ICON_COUNT][3] = {
+    "00", "01", "02", "03", "04", "05", "06", "07", "08", "09",
+    "10", "11", "12", "13", "14", "15", "16", "17", "18", "19",
+    "20", "21", "22", "23", "24", "25", "26", "27", "28", "29",
+    "30", "31", "32", "33", "34", "35", "36", "37", "38", "39",
+    "40", "41", "42", "43", "44", "45", "46", "47"
+};
+
+struct SlugEntry {
+    std::string_view slug;
+    int8_t icon;
+    bool precipitation;     // Shown as partly cloudy at 20% chance or less
+};
+
+// NWS forecast icon slugs (https://api.weather.gov/icons), sorted
+constexpr SlugEntry NWS_SLUGS[] = {
+    {"bkn", 3, false},          // Broken clouds -> Mostly cloudy
+    {"few", 2, false},          // Few clouds -> Partly cloudy day
+    {"fg", 20, false},          // Fog
+    {"haze", 20, false},        // Haze -> Fog
+    {"hi_shwrs", 9, true},      // Heavy showers -> Rain day
+    {"hi_tsra", 17, false},     // Heavy thunderstorm
+    {"mix", 13, false},         // Rain/snow mix -> Snow day
+    {"ovc", 4, false},          // Overcast -> Cloudy
+    {"ra", 9, false},           // Rain -> Rain day
+    {"rain", 9, true},
+    {"rain_showers", 9, true},  // Showers -> Rain day
+    {"sct", 2, false},          // Scattered clouds -> Partly cloudy day
+    {"shra", 9, false},
+    {"skc", 1, false},          // Sky clear -> Clear day
+    {"sn", 13, false},          // Snow -> Snow day
+    {"snow", 13, false},
+    {"tsra", 17, false},        // Thunderstorm
+    {"wind", 2, false}          // Windy -> Partly cloudy (no specific wind icon)
+};
+
+constexpr bool isSorted(const SlugEntry* entries, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        if (!(entries[i - 1].slug < entries[i].slug)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isSorted(NWS_SLUGS, std::size(NWS_SLUGS)), "NWS_SLUGS must be sorted");
+
+} // namespace
+
+Condition parseCondition(std::string_view weather) {
+    uint8_t flags = weatherFlags(weather);
+    bool rain = flags & WX_RAIN;
+    bool snow = flags & WX_SNOW;
+    
+    if (flags & WX_HAIL) return Condition::Hail;
+    if (flags & WX_THUNDER) return Condition::Thunder;
+    if ((flags & WX_SLEET) || (rain && snow)) return Condition::RainSnow;
+    if ((flags & WX_FREEZING) && rain) return Condition::FreezingRain;
+    if (flags & WX_FOG) return Condition::Fog;
+    if (snow) return Condition::Snow;
+    if (rain) return Condition::Rain;
+    if (flags & WX_BLOWING) return Condition::Blowing;
+    return Condition::Clear;
+}
+
+Intensity parseIntensity(std::string_view intensity) {
+    if (intensity == "very_light" || intensity == "light") return Intensity::Light;
+    if (intensity == "moderate") return Intensity::Moderate;
+    if (intensity == "heavy" || intensity == "very_heavy") return Intensity::Heavy;
+    return Intensity::Unknown;
+}
+
+SkyCover skyCoverBucket(int percent) {
+    if (percent > 80) return SkyCover::Overcast;
+    if (percent > 60) return SkyCover::Mostly;
+    if (percent > 40) return SkyCover::Partly;
+    if (percent > 25) return SkyCover::Few;
+    return SkyCover::Clear;
+}
+
+size_t iconKeyIndex(const IconKey& key) {
+    size_t index = static_cast<size_t>(key.condition);
+    index = index * static_cast<size_t>(Intensity::Count) + static_cast<size_t>(key.intensity);
+    index = index * 2 + (key.day ? 1 : 0);
+    index = index * static_cast<size_t>(SkyCover::Count) + static_cast<size_t>(key.sky);
+    index = index * 2 + (key.hot ? 1 : 0);
+    return index;
+}
+
+uint8_t iconFor(const IconKey& key) {
+    return ICON_TABLE[iconKeyIndex(key)];
+}
+
+const char* iconName(int icon) {
+    return (icon >= 0 && icon < ICON_COUNT) ? ICON_NAMES[icon] : "na";
+}
+
+const char* iconForNWSSlug(std::string_view slug) {
+    // Split off the probability, e.g. "rain_showers,30"
+    std::string_view base = slug;
+    int probability = 100;
+    size_t comma = slug.find(',');
+    if (comma != std::string_view::npos) {
+        base = slug.substr(0, comma);
+        probability = std::atoi(std::string(slug.substr(comma + 1)).c_str());
+    }
+    
+    auto it = std::lower_bound(std::begin(NWS_SLUGS), std::end(NWS_SLUGS), base,
+                               [](const SlugEntry& entry, std::string_view key) {
+                                   return entry.slug < key;
+                               });
+    bool known = it != std::end(NWS_SLUGS) && it->slug == base;
+    
+    // A slight chance usually means mostly clear: prefer partly cloudy
+    bool precipitation = known ? it->precipitation
+                               : (base.find("rain") != std::string_view::npos ||
+                                  base.find("shwr") != std::string_view::npos);
+    if (probability <= 20 && precipitation) {
+        return iconName(2);
+    }
+    
+    if (known) {
+        return iconName(it->icon);
+    }
+    
+    // Default fallback based on common patterns
+    if (base.find("rain") != std::string_view::npos) return iconName(9);
+    if (base.find("snow") != std::string_view::npos) return iconName(13);
+    if (base.find("storm") != std::string_view::npos) return iconName(17);
+    if (base.find("cloud") != std::string_view::npos) return iconName(3);
+    return "na";
+}
@@ -0,0 +1,71 @@
+#ifndef WEATHER_CONDITION_H
+#define WEATHER_CONDITION_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Dominant weather of a gridpoint interval, highest priority last
+enum class Condition : uint8_t {
+    Clear,          // Nothing falling; the icon follows sky cover
+    Blowing,
+    Rain,
+    Snow,
+    Fog,
+    FreezingRain,
+    RainSnow,       // Sleet, or rain and snow together
+    Thunder,
+    Hail,
+    Count
+};
+
+enum class Intensity : uint8_t {
+    Unknown,        // Missing; treated like heavy, as NWS omits it for strong events
+    Light,          // "very_light" or "light"
+    Moderate,
+    Heavy,          // "heavy" or "very_heavy"
+    Count
+};
+
+// Sky cover percentage in the buckets the icons distinguish
+enum class SkyCover : uint8_t {
+    Clear,          // 0-25%
+    Few,            // 26-40%
+    Partly,         // 41-60%
+    Mostly,         // 61-80%
+    Overcast,       // 81-100%
+    Count
+};
+
+// Tokenise an NWS gridpoint weather code such as "rain_showers" or
+// "freezing_drizzle". Known codes are a table lookup; anything else falls
+// back to a case-insensitive keyword scan.
+Condition parseCondition(std::string_view weather);
+Intensity parseIntensity(std::string_view intensity);
+SkyCover skyCoverBucket(int percent);
+
+struct IconKey {
+    Condition condition = Condition::Clear;
+    Intensity intensity = Intensity::Unknown;
+    bool day = true;
+    SkyCover sky = SkyCover::Clear;
+    bool hot = false;   // Above 38°C; only matters for a clear day
+};
+
+// Number of distinct IconKeys, and a key's index into the icon table
+constexpr size_t ICON_KEY_COUNT = static_cast<size_t>(Condition::Count) *
+                                  static_cast<size_t>(Intensity::Count) * 2 *
+                                  static_cast<size_t>(SkyCover::Count) * 2;
+size_t iconKeyIndex(const IconKey& key);
+
+// Icon number (0-47) from a table generated at compile time
+uint8_t iconFor(const IconKey& key);
+
+// "00".."47" for an icon number, "na" otherwise; never allocates
+const char* iconName(int icon);
+
+// Icon for an NWS forecast icon slug with an optional probability, e.g.
+// "tsra_hi,40" from .../icons/land/day/tsra_hi,40. "na" if unknown.
+const char* iconForNWSSlug(std::string_view slug);
+
+#endif // WEATHER_CONDITION_H
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <ctime>
 
+class HourlyForecast;
+
 /**
  * Weather data structure containing all information needed for display
  */
@@ -24,11 +27,15 @@ struct WeatherData {
     std::string weather_description = "";
     std::string location = "Unknown";  // Changed from location_name
     
+    // Hourly forecast columns; null unless hourly ingestion is enabled
+    std::shared_ptr<const HourlyForecast> hourly;
+    
     // Timestamp for caching
     std::time_t timestamp = 0;
     
     // Status
     bool is_valid = false;
+    bool is_stale = false;  // Last-known-good data shown while a live fetch is unavailable
     std::string error_message;
     
     // Helper methods (converting to int for display)
@@ -1,16 +1,77 @@
 #include "weather_service.h"
+#include "hourly_forecast.h"
+#include "gridpoint_series.h"
+#include "detached_task.h"
+#include "station_index.h"
+#include "weather_condition.h"
 #include <iostream>
 #include <cmath>
 #include <chrono>
 #include <ctime>
+#include <future>
+#include <thread>
+#include <atomic>
+
+namespace {
+
+const char* const SOURCE_NAMES[] = { "observation", "gridpoint", "forecast", "hourly" };
+
+// Run the /points and stations lookups for a location
+ResolvedEndpoints resolveEndpoints(NWSClient& client, double latitude, double longitude, std::string& error) {
+    ResolvedEndpoints endpoints;
+    endpoints.latitude = latitude;
+    endpoints.longitude = longitude;
+    
+    endpoints.points = client.getPoints(latitude, longitude);
+    if (!endpoints.points.valid) {
+        error = "Failed to get NWS points: " + client.getLastError();
+        return endpoints;
+    }
+    
+    endpoints.stations = client.getStations(endpoints.points.stations_url, latitude, longitude,
+                                            STATION_INDEX_SIZE);
+    if (endpoints.stations.empty()) {
+        error = "No weather stations found";
+        return endpoints;
+    }
+    
+    endpoints.resolved_at = std::time(nullptr);
+    return endpoints;
+}
+
+} // namespace
+
+bool isSourceDue(std::chrono::steady_clock::time_point fetched_at, std::time_t data_time,
+                 std::chrono::seconds ttl, std::chrono::steady_clock::time_point now,
+                 std::time_t wall_now) {
+    auto since_fetch = now - fetched_at;
+    if (data_time == 0) {
+        return since_fetch >= ttl;
+    }
+    
+    // Due once the data itself is ttl old. Data that was already that old
+    // when fetched (an hourly station, a late gridpoint update) is polled
+    // every half ttl rather than on every refresh.
+    return wall_now - data_time >= static_cast<std::time_t>(ttl.count()) &&
+           since_fetch >= ttl / 2;
+}
 
 WeatherService::WeatherService()
-    : client_(std::make_unique<NWSClient>())
+    : client_(std::make_shared<NWSClient>())
+    , station_index_(std::make_shared<StationIndex>())
     , latitude_(44.1076)  // Default to Mount Marcy
     , longitude_(-73.9209)
-    , cache_timeout_minutes_(10)
+    , fetch_timeout_seconds_(30)
+    , hourly_forecast_enabled_(false)
+    , stats_logging_(false)
     , endpoints_initialized_(false)
+    , endpoint_revalidate_hours_(24)
+    , endpoints_resolved_at_(0)
+    , endpoint_retry_after_(0)
 {
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        sources_[i].stats.source = SOURCE_NAMES[i];
+    }
 }
 
 WeatherService::~WeatherService() {
@@ -22,7 +83,17 @@ void WeatherService::setLocation(double latitude, double longitude) {
         latitude_ = latitude;
         longitude_ = longitude;
         endpoints_initialized_ = false;
+        endpoint_revalidation_ = std::future<ResolvedEndpoints>();  // Drop any revalidation for the old location
         cached_data_ = WeatherData(); // Clear cache
+        resetSources();
+    }
+}
+
+void WeatherService::setEndpointCacheFile(const std::string& path) {
+    if (path.empty()) {
+        endpoint_cache_.reset();
+    } else {
+        endpoint_cache_ = std::make_shared<EndpointCache>(path);
     }
 }
 
@@ -30,143 +101,412 @@ void WeatherService::setUserAgent(const std::string& user_agent) {
     client_->setUserAgent(user_agent);
 }
 
-bool WeatherService::isCacheValid() const {
-    if (!cached_data_.is_valid) {
-        return false;
+WeatherService::GridWindow WeatherService::gridWindow(const GridpointSeries& series, std::time_t t) {
+    return {
+        series.temperature.index.find(t),
+        series.precipitation_chance.index.find(t),
+        series.sky_cover.index.find(t),
+        series.weather.index.find(t),
+        localDayWindow(t).first,
+    };
+}
+
+void WeatherService::resetSources() {
+    for (auto& source : sources_) {
+        const char* name = source.stats.source;
+        source = SourceState();
+        source.stats.source = name;
+    }
+    observation_ = NWSObservation();
+    grid_series_.reset();
+    grid_window_ = GridWindow{};
+    icon_forecast_ = NWSForecast();
+    hourly_.reset();
+}
+
+bool WeatherService::isDue(DataSource source, std::chrono::steady_clock::time_point now, std::time_t wall_now) const {
+    const SourceState& state = sources_[source];
+    if (!state.has_data) {
+        return true;
     }
     
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::minutes>(now - last_fetch_time_);
+    std::chrono::seconds ttl;
+    switch (source) {
+        case SOURCE_OBSERVATION: ttl = freshness_.observation_ttl; break;
+        case SOURCE_GRIDPOINT: ttl = freshness_.gridpoint_ttl; break;
+        case SOURCE_FORECAST: ttl = freshness_.forecast_ttl; break;
+        default: ttl = freshness_.hourly_ttl; break;
+    }
     
-    return elapsed.count() < cache_timeout_minutes_;
+    return isSourceDue(state.fetched_at, state.data_time, ttl, now, wall_now);
+}
+
+bool WeatherService::anySourceDue() const {
+    auto now = std::chrono::steady_clock::now();
+    std::time_t wall_now = std::time(nullptr);
+    if (isDue(SOURCE_OBSERVATION, now, wall_now) || isDue(SOURCE_GRIDPOINT, now, wall_now)) {
+        return true;
+    }
+    if (!grid_series_ && isDue(SOURCE_FORECAST, now, wall_now)) {
+        return true;
+    }
+    return hourly_forecast_enabled_ && isDue(SOURCE_HOURLY, now, wall_now);
+}
+
+void WeatherService::countSkipped(bool observation_due, bool grid_due, bool forecast_due, bool hourly_due) {
+    if (!observation_due) sources_[SOURCE_OBSERVATION].stats.skipped++;
+    if (!grid_due) sources_[SOURCE_GRIDPOINT].stats.skipped++;
+    // The text forecast and hourly data only count when they are in use
+    if (!forecast_due && !grid_series_) sources_[SOURCE_FORECAST].stats.skipped++;
+    if (!hourly_due && hourly_forecast_enabled_) sources_[SOURCE_HOURLY].stats.skipped++;
+}
+
+std::vector<SourceFetchStats> WeatherService::getSourceStats() const {
+    std::vector<SourceFetchStats> stats;
+    for (const auto& source : sources_) {
+        stats.push_back(source.stats);
+    }
+    return stats;
 }
 
 WeatherData WeatherService::fetchWeatherData() {
-    if (isCacheValid()) {
+    if (cached_data_.is_valid && endpoints_initialized_ && !anySourceDue()) {
+        countSkipped(false, false, false, false);
         return cached_data_;
     }
     
-    return forceFetch();
+    return fetchAndLog(false);
 }
 
 WeatherData WeatherService::forceFetch() {
-    WeatherData data = fetchFromAPI();
+    return fetchAndLog(true);
+}
+
+WeatherData WeatherService::fetchAndLog(bool force) {
+    WeatherData data = fetchFromAPI(force);
+    
+    if (stats_logging_) {
+        printFetchStats();
+    }
     
     if (data.is_valid) {
         cached_data_ = data;
-        last_fetch_time_ = std::chrono::steady_clock::now();
     }
     
     return data;
 }
 
-WeatherData WeatherService::fetchFromAPI() {
-    WeatherData data;
+void WeatherService::printFetchStats() const {
+    ConnectionStats conn = client_->getConnectionStats();
+    std::cout << "NWS connections: " << conn.connections_opened << " opened, "
+              << conn.connections_reused << " reused, "
+              << conn.reconnects << " reconnects" << std::endl;
     
-    try {
-        // Step 1: Get points data if not initialized
-        if (!endpoints_initialized_) {
-            std::cout << "Fetching NWS endpoints for location..." << std::endl;
-            
-            NWSPoints points = client_->getPoints(latitude_, longitude_);
-            if (!points.valid) {
-                last_error_ = "Failed to get NWS points: " + client_->getLastError();
-                data.error_message = last_error_;
-                return data;
-            }
-            
-            forecast_grid_url_ = points.forecast_grid_url;
-            forecast_url_ = points.forecast_url;
-            stations_url_ = points.stations_url;
-            
-            // Get nearest station
-            auto stations = client_->getStations(stations_url_, latitude_, longitude_);
-            if (stations.empty()) {
-                last_error_ = "No weather stations found";
-                data.error_message = last_error_;
-                return data;
-            }
-            
-            nearest_station_id_ = stations[0].id;
-            std::cout << "Using station: " << stations[0].name << " (" << nearest_station_id_ << ")" << std::endl;
-            
-            endpoints_initialized_ = true;
+    CacheStats cache = client_->getCacheStats();
+    std::cout << "NWS response cache: " << cache.fresh_hits << " fresh, "
+              << cache.not_modified << " not modified, "
+              << cache.misses << " downloaded" << std::endl;
+    
+    TransferStats transfer = client_->getTransferStats();
+    std::cout << "NWS transfer: " << transfer.wire_bytes << " bytes on wire, "
+              << transfer.decoded_bytes << " bytes decoded" << std::endl;
+    
+    ObservationQueryStats obs = client_->getObservationQueryStats();
+    std::cout << "NWS observations: " << obs.latest_hits << " latest, "
+              << obs.fallbacks << " fallbacks, "
+              << obs.widenings << " widenings, "
+              << obs.unchanged << " unchanged, ~"
+              << obs.bytes_saved << " bytes saved" << std::endl;
+    
+    for (const auto& station : station_index_->getHealthStats(std::time(nullptr))) {
+        if (station.attempts > 0 && !station.healthy) {
+            std::cout << "NWS station " << station.station_id << " unhealthy: "
+                      << station.valid << "/" << station.attempts << " valid, score "
+                      << station.score << std::endl;
         }
-        
-        // Step 2: Get current observations
-        NWSObservation obs = client_->getLatestObservation(nearest_station_id_);
-        if (!obs.valid) {
-            std::cout << "Warning: Could not get current observations" << std::endl;
-        } else {
-            if (obs.temperature_celsius.has_value()) {
-                data.temperature_c = obs.temperature_celsius.value();
-            }
-            if (obs.dewpoint_celsius.has_value()) {
-                data.dewpoint_c = obs.dewpoint_celsius.value();
-            }
-            if (obs.wind_speed_kmh.has_value()) {
-                data.wind_speed_kmh = obs.wind_speed_kmh.value();
-            }
-            if (obs.wind_direction_degrees.has_value()) {
-                data.wind_direction_deg = obs.wind_direction_degrees.value();
-            }
-            if (obs.humidity_percent.has_value()) {
-                data.humidity_percent = static_cast<int>(obs.humidity_percent.value());
-            }
-            data.weather_description = obs.text_description;
+    }
+    
+    for (const auto& retry : client_->getRetryStats()) {
+        if (retry.retries == 0 && retry.failures == 0 && retry.short_circuited == 0) {
+            continue;
         }
-        
-        // Step 3: Get grid forecast data for detailed weather conditions
-        NWSForecast grid_forecast = client_->getForecast(forecast_grid_url_);
-        if (grid_forecast.valid) {
-            if (grid_forecast.temperature_max_celsius.has_value()) {
-                data.temperature_max_c = grid_forecast.temperature_max_celsius.value();
-            }
-            if (grid_forecast.temperature_min_celsius.has_value()) {
-                data.temperature_min_c = grid_forecast.temperature_min_celsius.value();
-            }
-            if (grid_forecast.precipitation_chance_percent.has_value()) {
-                data.precipitation_chance_percent = grid_forecast.precipitation_chance_percent.value();
-            }
+        std::cout << "NWS " << retry.endpoint << " retries: " << retry.retries << " retries, "
+                  << retry.failures << " failures, "
+                  << retry.short_circuited << " short-circuited, "
+                  << retry.stale_served << " served stale, breaker "
+                  << circuitStateName(retry.state) << std::endl;
+    }
+    
+    std::cout << "NWS sources (fetched/skipped while fresh/unchanged):";
+    for (const auto& source : sources_) {
+        std::cout << " " << source.stats.source << " " << source.stats.fetches << "/"
+                  << source.stats.skipped << "/" << source.stats.unchanged;
+    }
+    std::cout << std::endl;
+}
 
-            // Determine the weather icon based on conditions like Python version
-            data.weather_icon = determineWeatherIcon(grid_forecast, obs);
+bool WeatherService::initializeEndpoints() {
+    if (endpoint_cache_) {
+        auto cached = endpoint_cache_->load(latitude_, longitude_);
+        if (cached.has_value()) {
+            std::cout << "Loaded NWS endpoints from " << endpoint_cache_->path() << std::endl;
+            applyEndpoints(cached.value());
+            return true;
+        }
+    }
+    
+    std::cout << "Fetching NWS endpoints for location..." << std::endl;
+    
+    std::string error;
+    ResolvedEndpoints endpoints = resolveEndpoints(*client_, latitude_, longitude_, error);
+    if (!endpoints.isValid()) {
+        last_error_ = error;
+        return false;
+    }
+    
+    applyEndpoints(endpoints);
+    if (endpoint_cache_) {
+        endpoint_cache_->store(endpoints);
+    }
+    return true;
+}
 
-            if (!grid_forecast.weather_condition.empty()) {
-                data.weather_description = grid_forecast.weather_condition;
+void WeatherService::applyEndpoints(const ResolvedEndpoints& endpoints) {
+    forecast_grid_url_ = endpoints.points.forecast_grid_url;
+    forecast_url_ = endpoints.points.forecast_url;
+    forecast_hourly_url_ = endpoints.points.forecast_hourly_url;
+    stations_url_ = endpoints.points.stations_url;
+    station_index_->reset(endpoints.stations);
+    endpoints_resolved_at_ = endpoints.resolved_at;
+    endpoints_initialized_ = true;
+    
+    const NWSStation& nearest = endpoints.stations[0];
+    std::cout << "Using station: " << nearest.name << " (" << nearest.id << "), "
+              << (endpoints.stations.size() - 1) << " more for failover" << std::endl;
+}
+
+void WeatherService::checkEndpointRevalidation() {
+    std::time_t now = std::time(nullptr);
+    
+    // Pick up a finished background revalidation
+    if (endpoint_revalidation_.valid() &&
+        endpoint_revalidation_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        ResolvedEndpoints endpoints = endpoint_revalidation_.get();
+        if (endpoints.isValid()) {
+            if (endpoints.points.forecast_grid_url != forecast_grid_url_ ||
+                endpoints.stations[0].id != station_index_->primary().id) {
+                std::cout << "NWS endpoints changed on revalidation" << std::endl;
+                resetSources();
             }
+            applyEndpoints(endpoints);
         } else {
-            // Fallback to simple forecast with NWS icons
-            NWSForecast forecast = client_->getForecastWithIcon(forecast_url_);
-            if (forecast.valid) {
-                if (forecast.temperature_max_celsius.has_value()) {
-                    data.temperature_max_c = forecast.temperature_max_celsius.value();
+            endpoint_retry_after_ = now + ENDPOINT_RETRY_SECONDS;
+        }
+    }
+    
+    if (!endpoints_initialized_ || endpoint_revalidation_.valid() || now < endpoint_retry_after_) {
+        return;
+    }
+    if (now - endpoints_resolved_at_ < static_cast<std::time_t>(endpoint_revalidate_hours_) * 60 * 60) {
+        return;
+    }
+    
+    // Re-resolve off the fetch path; the current endpoints stay in use meanwhile
+    std::cout << "Revalidating NWS endpoints in the background" << std::endl;
+    auto client = client_;
+    auto cache = endpoint_cache_;
+    double latitude = latitude_;
+    double longitude = longitude_;
+    endpoint_revalidation_ = runDetached([client, cache, latitude, longitude]() {
+        std::string error;
+        ResolvedEndpoints endpoints = resolveEndpoints(*client, latitude, longitude, error);
+        if (!endpoints.isValid()) {
+            std::cerr << "Endpoint revalidation failed: " << error << std::endl;
+        } else if (cache) {
+            cache->store(endpoints);
+        }
+        return endpoints;
+    });
+}
+
+WeatherData WeatherService::fetchFromAPI(bool force) {
+    WeatherData data;
+    
+    try {
+        // Step 1: Resolve endpoints, from the on-disk cache when possible
+        if (!endpoints_initialized_ && !initializeEndpoints()) {
+            data.error_message = last_error_;
+            return data;
+        }
+        checkEndpointRevalidation();
+        
+        // Step 2: Issue requests, concurrently, for the sources past their TTL
+        auto now = std::chrono::steady_clock::now();
+        std::time_t wall_now = std::time(nullptr);
+        bool observation_due = force || isDue(SOURCE_OBSERVATION, now, wall_now);
+        bool grid_due = force || isDue(SOURCE_GRIDPOINT, now, wall_now);
+        bool hourly_due = hourly_forecast_enabled_ && !forecast_hourly_url_.empty() &&
+                          (force || isDue(SOURCE_HOURLY, now, wall_now));
+        // The text forecast is only needed if the gridpoints fail: request
+        // it speculatively alongside a gridpoint fetch and cancel it once
+        // that succeeds, or on its own TTL while no gridpoints are held
+        bool forecast_due = grid_due || (!grid_series_ && (force || isDue(SOURCE_FORECAST, now, wall_now)));
+        
+        countSkipped(observation_due, grid_due, forecast_due, hourly_due);
+        
+        auto client = client_;
+        auto cancel_icon = std::make_shared<std::atomic<bool>>(false);
+        auto station_index = station_index_;
+        std::string grid_url = forecast_grid_url_;
+        std::string forecast_url = forecast_url_;
+        auto deadline = now + std::chrono::seconds(fetch_timeout_seconds_);
+        
+        std::future<NWSObservation> obs_future;
+        if (observation_due) {
+            // Nearest healthy station, failing over down the ranking within
+            // the same deadline the result is waited on with
+            obs_future = runDetached([client, station_index, deadline]() {
+                return fetchObservationWithFailover(*client, *station_index, nullptr, deadline);
+            });
+        }
+        std::future<std::shared_ptr<const GridpointSeries>> grid_future;
+        if (grid_due) {
+            grid_future = runDetached([client, grid_url]() {
+                return client->getGridpointSeries(grid_url);
+            });
+        }
+        std::future<NWSForecast> icon_future;
+        if (forecast_due) {
+            icon_future = runDetached([client, forecast_url, cancel_icon]() {
+                return client->getForecastWithIcon(forecast_url, cancel_icon.get());
+            });
+        }
+        std::future<std::shared_ptr<const HourlyForecast>> hourly_future;
+        if (hourly_due) {
+            std::string hourly_url = forecast_hourly_url_;
+            hourly_future = runDetached([client, hourly_url]() {
+                return client->getHourlyForecast(hourly_url);
+            });
+        }
+        
+        bool changed = false;
+        // A due source that failed leaves its old data in the merge; the
+        // result is then marked stale rather than presented as current.
+        // Hourly data is not displayed, so it does not count.
+        bool observation_failed = false;
+        bool forecast_failed = false;
+        
+        // Step 3: Current observations; an unchanged timestamp means the
+        // station has not reported since the last fetch
+        if (obs_future.valid()) {
+            SourceState& source = sources_[SOURCE_OBSERVATION];
+            source.stats.fetches++;
+            NWSObservation obs = waitUntil(obs_future, deadline);
+            if (!obs.valid) {
+                std::cout << "Warning: Could not get current observations" << std::endl;
+                observation_failed = true;
+            } else {
+                if (observation_.valid && obs.timestamp == observation_.timestamp) {
+                    source.stats.unchanged++;
+                } else {
+                    observation_ = obs;
+                    changed = true;
                 }
-                if (forecast.precipitation_chance_percent.has_value()) {
-                    data.precipitation_chance_percent = forecast.precipitation_chance_percent.value();
+                int64_t observed = 0;
+                source.data_time = parseIsoTimestamp(obs.timestamp, observed) ? static_cast<std::time_t>(observed) : 0;
+                source.fetched_at = now;
+                source.has_data = true;
+            }
+        }
+        
+        // Step 4: Gridpoint forecast. A 304 or fresh cache hit hands back
+        // the same decoded series.
+        if (grid_future.valid()) {
+            SourceState& source = sources_[SOURCE_GRIDPOINT];
+            source.stats.fetches++;
+            auto series = waitUntil(grid_future, deadline);
+            if (series) {
+                cancel_icon->store(true);
+                // The same series still changes the merge once the clock
+                // crosses into a new interval or day
+                if (series == grid_series_ && gridWindow(*series, wall_now) == grid_window_) {
+                    source.stats.unchanged++;
+                } else {
+                    grid_series_ = series;
+                    changed = true;
                 }
-                if (!forecast.weather_icon.empty()) {
-                    data.weather_icon = forecast.weather_icon;
+                source.data_time = static_cast<std::time_t>(series->update_time);
+                source.fetched_at = now;
+                source.has_data = true;
+            } else {
+                // Cleared below if the text forecast stands in for it
+                forecast_failed = true;
+            }
+        }
+        
+        // Fallback to simple forecast with NWS icons
+        if (icon_future.valid()) {
+            if (!grid_series_) {
+                SourceState& source = sources_[SOURCE_FORECAST];
+                source.stats.fetches++;
+                NWSForecast forecast = waitUntil(icon_future, deadline);
+                if (forecast.valid) {
+                    icon_forecast_ = forecast;
+                    source.fetched_at = now;
+                    source.has_data = true;
+                    changed = true;
+                    forecast_failed = false;
                 } else {
-                    data.weather_icon = "na";
+                    forecast_failed = true;
                 }
-                data.weather_description = forecast.weather_condition;
+            }
+            // Stop the speculative download if it is still running
+            cancel_icon->store(true);
+        }
+        
+        if (hourly_future.valid()) {
+            SourceState& source = sources_[SOURCE_HOURLY];
+            source.stats.fetches++;
+            auto hourly = waitUntil(hourly_future, deadline);
+            if (!hourly) {
+                std::cout << "Warning: Could not get hourly forecast" << std::endl;
             } else {
-                data.weather_icon = "na";
+                if (hourly == hourly_) {
+                    source.stats.unchanged++;
+                } else {
+                    hourly_ = hourly;
+                    changed = true;
+                }
+                source.fetched_at = now;
+                source.has_data = true;
             }
         }
         
-        // Mark as valid if we got at least some data
-        if (obs.valid || grid_forecast.valid) {
-            data.is_valid = true;
-            data.location = "Lat: " + std::to_string(latitude_) + ", Lon: " + std::to_string(longitude_);
-            
-            // Update timestamp
-            auto now = std::time(nullptr);
-            data.timestamp = std::time(nullptr);
-        } else {
-            last_error_ = "No valid data received from NWS";
-            data.error_message = last_error_;
+        bool failed = observation_failed || forecast_failed;
+        
+        // Nothing new: hand back the merged data as it was, timestamp
+        // included, so callers can tell nothing changed. Data that was
+        // stale is current again once every due source has answered.
+        if (!changed && cached_data_.is_valid) {
+            data = cached_data_;
+            if (failed) {
+                data.is_stale = true;
+            } else if (data.is_stale) {
+                data.is_stale = false;
+                data.timestamp = wall_now;
+            }
+            return data;
+        }
+        
+        data = mergeSources(wall_now);
+        
+        // Part of the merge is left over from an earlier fetch: keep the
+        // time the data was last wholly current instead of stamping it now
+        if (failed && data.is_valid) {
+            data.is_stale = true;
+            if (cached_data_.is_valid) {
+                data.timestamp = cached_data_.timestamp;
+            }
         }
         
     } catch (const std::exception& e) {
@@ -178,131 +518,106 @@ WeatherData WeatherService::fetchFromAPI() {
     return data;
 }
 
+WeatherData WeatherService::mergeSources(std::time_t wall_now) {
+    WeatherData data;
+    
+    if (observation_.valid) {
+        applyObservation(data, observation_);
+    }
+    
+    // Grid forecast data for detailed weather conditions
+    NWSForecast grid_forecast;
+    if (grid_series_) {
+        grid_forecast = grid_series_->forecastAt(wall_now);
+        grid_window_ = gridWindow(*grid_series_, wall_now);
+        applyGridForecast(data, grid_forecast, observation_);
+    } else {
+        applyIconForecast(data, icon_forecast_);
+    }
+    
+    data.hourly = hourly_;
+    
+    // Mark as valid if we got at least some data
+    if (observation_.valid || grid_forecast.valid) {
+        data.is_valid = true;
+        data.location = "Lat: " + std::to_string(latitude_) + ", Lon: " + std::to_string(longitude_);
+        
+        // Update timestamp
+        data.timestamp = std::time(nullptr);
+    } else {
+        last_error_ = "No valid data received from NWS";
+        data.error_message = last_error_;
+    }
+    
+    return data;
+}
 
+void WeatherService::applyObservation(WeatherData& data, const NWSObservation& obs) {
+    if (obs.temperature_celsius.has_value()) {
+        data.temperature_c = obs.temperature_celsius.value();
+    }
+    if (obs.dewpoint_celsius.has_value()) {
+        data.dewpoint_c = obs.dewpoint_celsius.value();
+    }
+    if (obs.wind_speed_kmh.has_value()) {
+        data.wind_speed_kmh = obs.wind_speed_kmh.value();
+    }
+    if (obs.wind_direction_degrees.has_value()) {
+        data.wind_direction_deg = obs.wind_direction_degrees.value();
+    }
+    if (obs.humidity_percent.has_value()) {
+        data.humidity_percent = static_cast<int>(obs.humidity_percent.value());
+    }
+    data.weather_description = obs.text_description;
+}
 
-std::string WeatherService::determineWeatherIcon(const NWSForecast& forecast, const NWSObservation& obs) const {
-    // Determine the appropriate weather icon based on weather conditions
-    // This follows the logic from the Python version
-
-    // Get current time to determine day/night
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-    std::tm* local_time = std::localtime(&now_time);
-    int hour = local_time->tm_hour;
-    bool is_day = (hour >= 6 && hour < 18);
-
-    // Get weather conditions
-    std::string weather = forecast.weather_condition;
-    std::string intensity = forecast.weather_intensity;
-    int sky_cover = forecast.sky_cover_percent.value_or(0);
-
-    // Check for various weather conditions
-    bool is_foggy = (weather.find("fog") != std::string::npos) ||
-                    (weather.find("Fog") != std::string::npos);
-    bool is_blowing = (weather.find("blowing") != std::string::npos) ||
-                      (weather.find("Blowing") != std::string::npos) ||
-                      (weather.find("wind") != std::string::npos) ||
-                      (weather.find("Wind") != std::string::npos);
-    bool is_thunder = (weather.find("thunder") != std::string::npos) ||
-                      (weather.find("Thunder") != std::string::npos);
-    bool is_rain = (weather.find("rain") != std::string::npos) ||
-                   (weather.find("Rain") != std::string::npos) ||
-                   (weather.find("drizzle") != std::string::npos) ||
-                   (weather.find("Drizzle") != std::string::npos) ||
-                   (weather.find("shower") != std::string::npos) ||
-                   (weather.find("Shower") != std::string::npos);
-    bool is_snow = (weather.find("snow") != std::string::npos) ||
-                   (weather.find("Snow") != std::string::npos);
-    bool is_freezing = (weather.find("freezing") != std::string::npos) ||
-                       (weather.find("Freezing") != std::string::npos);
-    bool is_hail = (weather.find("hail") != std::string::npos) ||
-                   (weather.find("Hail") != std::string::npos);
-    bool is_sleet = (weather.find("sleet") != std::string::npos) ||
-                    (weather.find("Sleet") != std::string::npos);
+void WeatherService::applyGridForecast(WeatherData& data, const NWSForecast& forecast, const NWSObservation& obs) {
+    if (forecast.temperature_max_celsius.has_value()) {
+        data.temperature_max_c = forecast.temperature_max_celsius.value();
+    }
+    if (forecast.temperature_min_celsius.has_value()) {
+        data.temperature_min_c = forecast.temperature_min_celsius.value();
+    }
+    if (forecast.precipitation_chance_percent.has_value()) {
+        data.precipitation_chance_percent = forecast.precipitation_chance_percent.value();
+    }
 
-    // Check intensity
-    bool is_light = (intensity == "very_light" || intensity == "light");
-    bool is_moderate = (intensity == "moderate");
-    bool is_heavy = (intensity == "heavy" || intensity == "very_heavy");
+    // Determine the weather icon based on conditions like Python version
+    data.weather_icon = determineWeatherIcon(forecast, obs);
 
-    // Map to icon numbers based on conditions
-    // The icon mapping is based on analyzing the actual icon images:
-    // 00-07: Heavy rain/storm variations
-    // 08-15: Light to moderate rain/clouds
-    // 16: Light clouds/sun day
-    // 17: Thunderstorm
-    // 18: Fog
-    // 19: Clear sun
-    // 20: Fog
-    // 21: Moon (clear night)
-    // 22: Sun hot
-    // 23: Light clouds/moon night
-    // 24-31: Night variations
-    // 32-39: Day variations with weather
-    // 40-47: Thunderstorms and special conditions
+    if (!forecast.weather_condition.empty()) {
+        data.weather_description = forecast.weather_condition;
+    }
+}
 
-    if (is_hail) {
-        return "04";  // Hail storm
-    } else if (is_thunder) {
-        if (is_light) {
-            return is_day ? "03" : "38";  // Light thunderstorm day/night
-        } else {
-            return "17";  // Heavy thunderstorm
-        }
-    } else if (is_sleet || (is_rain && is_snow)) {
-        return "05";  // Rain/snow mix
-    } else if (is_freezing && is_rain) {
-        if (is_heavy) {
-            return "02";  // Heavy freezing rain
-        } else {
-            return "01";  // Light freezing rain
-        }
-    } else if (is_foggy) {
-        if (is_light) {
-            return is_day ? "18" : "20";  // Fog day/night
-        } else {
-            return "20";  // Heavy fog
-        }
-    } else if (is_snow) {
-        if (is_light) {
-            return is_day ? "14" : "46";  // Light snow day/night
-        } else if (is_moderate) {
-            return "13";  // Moderate snow
-        } else {
-            return "12";  // Heavy snow
-        }
-    } else if (is_rain) {
-        if (is_light) {
-            return is_day ? "09" : "45";  // Light rain day/night
-        } else if (is_moderate) {
-            return "10";  // Moderate rain
-        } else {
-            return "00";  // Heavy rain
-        }
-    } else if (is_blowing) {
-        return "23";  // Windy
-    } else {
-        // Clear or cloudy conditions based on sky cover
-        if (sky_cover > 80) {
-            return "16";  // Overcast clouds
-        } else if (sky_cover > 60) {
-            return is_day ? "26" : "31";  // Mostly cloudy day/night
-        } else if (sky_cover > 40) {
-            return is_day ? "28" : "27";  // Partly cloudy day/night
-        } else if (sky_cover > 25) {
-            return is_day ? "30" : "29";  // Few clouds day/night
-        } else {
-            // Clear sky
-            if (is_day) {
-                // Check if it is hot (temperature > 100F / 38C)
-                if (obs.temperature_celsius.value_or(0) > 38) {
-                    return "22";  // Hot sun
-                } else {
-                    return "19";  // Clear day
-                }
-            } else {
-                return "21";  // Clear night (moon)
-            }
-        }
+void WeatherService::applyIconForecast(WeatherData& data, const NWSForecast& forecast) {
+    if (!forecast.valid) {
+        data.weather_icon = "na";
+        return;
     }
+    if (forecast.temperature_max_celsius.has_value()) {
+        data.temperature_max_c = forecast.temperature_max_celsius.value();
+    }
+    if (forecast.precipitation_chance_percent.has_value()) {
+        data.precipitation_chance_percent = forecast.precipitation_chance_percent.value();
+    }
+    data.weather_icon = forecast.weather_icon.empty() ? "na" : forecast.weather_icon;
+    data.weather_description = forecast.weather_condition;
+}
+
+std::string WeatherService::determineWeatherIcon(const NWSForecast& forecast, const NWSObservation& obs) {
+    // Get current time to determine day/night
+    auto now = std::chrono::system_clock::now();
+    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
+    std::tm local_time = {};
+    localtime_r(&now_time, &local_time);  // Runs on the fetch worker
+    int hour = local_time.tm_hour;
+    
+    IconKey key;
+    key.condition = parseCondition(forecast.weather_condition);
+    key.intensity = parseIntensity(forecast.weather_intensity);
+    key.day = (hour >= 6 && hour < 18);
+    key.sky = skyCoverBucket(forecast.sky_cover_percent.value_or(0));
+    key.hot = obs.temperature_celsius.value_or(0) > 38;  // Above 100F
+    return iconName(iconFor(key));
 }
@@ -3,9 +3,39 @@
 
 #include "weather_data.h"
 #include "nws_client.h"
+#include "endpoint_cache.h"
+#include "station_index.h"
 #include <memory>
+#include <array>
 #include <chrono>
+#include <future>
 #include <string>
+#include <vector>
+#include <ctime>
+
+// How long each NWS data source is used before it is fetched again. For
+// observations and gridpoints the age counts from the data's own time
+// (observation timestamp, gridpoint updateTime) when the response has one.
+struct FreshnessPolicy {
+    std::chrono::seconds observation_ttl{10 * 60};
+    std::chrono::seconds gridpoint_ttl{60 * 60};
+    std::chrono::seconds forecast_ttl{60 * 60};  // Text forecast, the icon fallback
+    std::chrono::seconds hourly_ttl{60 * 60};
+};
+
+// True once data fetched at fetched_at has outlived ttl. data_time is the
+// time the data itself carries, 0 if none; shared with MultiLocationService
+bool isSourceDue(std::chrono::steady_clock::time_point fetched_at, std::time_t data_time,
+                 std::chrono::seconds ttl, std::chrono::steady_clock::time_point now,
+                 std::time_t wall_now);
+
+// Fetch counters for one data source
+struct SourceFetchStats {
+    const char* source = "";
+    uint64_t fetches = 0;    // Requests issued
+    uint64_t skipped = 0;    // Refreshes that reused still-fresh data
+    uint64_t unchanged = 0;  // Fetches that returned the data already held
+};
 
 class WeatherService {
 public:
@@ -16,41 +46,129 @@ public:
     void setLocation(double latitude, double longitude);
     
     // Fetch weather data from NWS API
-    // Returns cached data if recent enough (< 10 minutes old)
+    // Only sources past their FreshnessPolicy TTL are refetched; if none
+    // is, the cached data is returned without any request. When a due
+    // source fails the result keeps its older data and is marked is_stale,
+    // with the time it was last wholly current.
     WeatherData fetchWeatherData();
     
-    // Force a fresh fetch from the API (ignores cache)
+    // Force a fresh fetch of every source from the API (ignores TTLs)
     WeatherData forceFetch();
     
     // Configuration
-    void setCacheTimeout(int minutes) { cache_timeout_minutes_ = minutes; }
+    void setFreshnessPolicy(const FreshnessPolicy& policy) { freshness_ = policy; }
+    void setFetchTimeout(int seconds) { fetch_timeout_seconds_ = seconds; }
     void setUserAgent(const std::string& user_agent);
+    void setBaseUrl(const std::string& base_url) { client_->setBaseUrl(base_url); }
+    void setTransport(std::unique_ptr<HttpTransport> transport) { client_->setTransport(std::move(transport)); }
+    void setCompression(bool enabled) { client_->setCompression(enabled); }
+    void setTransferLogging(bool enabled) { client_->setTransferLogging(enabled); }
+    // Print connection, cache, retry and source counters after each fetch
+    void setStatsLogging(bool enabled) { stats_logging_ = enabled; }
+    void setMaxResponseBytes(size_t max_bytes) { client_->setMaxResponseBytes(max_bytes); }
+    
+    // Also ingest /forecast/hourly into WeatherData::hourly on each fetch
+    void setHourlyForecast(bool enabled) { hourly_forecast_enabled_ = enabled; }
+    
+    // Persist resolved endpoints so restarts skip the /points and stations
+    // lookups; an empty path disables the file
+    void setEndpointCacheFile(const std::string& path);
+    void setEndpointRevalidateInterval(int hours) { endpoint_revalidate_hours_ = hours; }
     
     // Get last error message
     std::string getLastError() const { return last_error_; }
     
+    // Connection reuse counters from the underlying client
+    ConnectionStats getConnectionStats() const { return client_->getConnectionStats(); }
+    CacheStats getCacheStats() const { return client_->getCacheStats(); }
+    TransferStats getTransferStats() const { return client_->getTransferStats(); }
+    ObservationQueryStats getObservationQueryStats() const { return client_->getObservationQueryStats(); }
+    std::vector<EndpointRetryStats> getRetryStats() const { return client_->getRetryStats(); }
+    std::vector<SourceFetchStats> getSourceStats() const;
+    std::vector<StationHealthStats> getStationHealth() const { return station_index_->getHealthStats(std::time(nullptr)); }
+    
+    // Merge NWS results into WeatherData; shared with MultiLocationService
+    static void applyObservation(WeatherData& data, const NWSObservation& obs);
+    static void applyGridForecast(WeatherData& data, const NWSForecast& forecast, const NWSObservation& obs);
+    // Fallback when the gridpoint forecast is unavailable; forecast may be invalid
+    static void applyIconForecast(WeatherData& data, const NWSForecast& forecast);
+    static std::string determineWeatherIcon(const NWSForecast& forecast, const NWSObservation& obs);
+    
 private:
-    WeatherData fetchFromAPI();
-    bool isCacheValid() const;
-    std::string determineWeatherIcon(const NWSForecast& forecast, const NWSObservation& obs) const;
+    enum DataSource { SOURCE_OBSERVATION, SOURCE_GRIDPOINT, SOURCE_FORECAST, SOURCE_HOURLY, SOURCE_COUNT };
     
-    std::unique_ptr<NWSClient> client_;
+    // Gridpoint intervals in effect at a time (temperature, precipitation,
+    // sky cover, weather) and the local day the high/low spans; the merged
+    // forecast from one series only moves when one of these does
+    using GridWindow = std::array<int64_t, 5>;
+    static GridWindow gridWindow(const GridpointSeries& series, std::time_t t);
+    
+    struct SourceState {
+        bool has_data = false;
+        std::chrono::steady_clock::time_point fetched_at;
+        std::time_t data_time = 0;  // Time the data itself carries; 0 if unknown
+        SourceFetchStats stats;
+    };
+    
+    WeatherData fetchAndLog(bool force);
+    WeatherData fetchFromAPI(bool force);
+    void printFetchStats() const;
+    
+    // True once a source has outlived its TTL
+    bool isDue(DataSource source, std::chrono::steady_clock::time_point now, std::time_t wall_now) const;
+    bool anySourceDue() const;
+    void countSkipped(bool observation_due, bool grid_due, bool forecast_due, bool hourly_due);
+    // Forget fetched data, e.g. after the location or its endpoints change
+    void resetSources();
+    
+    // Build WeatherData from the latest result of each source
+    WeatherData mergeSources(std::time_t wall_now);
+    
+    // Load endpoints from the on-disk cache, or resolve them from the API
+    bool initializeEndpoints();
+    void applyEndpoints(const ResolvedEndpoints& endpoints);
+    
+    // Apply a finished background revalidation and start a new one once
+    // the endpoints are older than the revalidate interval
+    void checkEndpointRevalidation();
+    
+    // Shared so that fetches still running after a timeout keep the client alive
+    std::shared_ptr<NWSClient> client_;
+    // Ranked stations with health, shared with in-flight observation fetches
+    std::shared_ptr<StationIndex> station_index_;
     
     double latitude_;
     double longitude_;
     
     WeatherData cached_data_;
-    std::chrono::steady_clock::time_point last_fetch_time_;
-    int cache_timeout_minutes_;
+    int fetch_timeout_seconds_;  // Deadline for the concurrent observation/forecast fetches
+    bool hourly_forecast_enabled_;
+    bool stats_logging_;
+    
+    // Latest result and schedule of each data source
+    FreshnessPolicy freshness_;
+    SourceState sources_[SOURCE_COUNT];
+    NWSObservation observation_;
+    std::shared_ptr<const GridpointSeries> grid_series_;
+    GridWindow grid_window_{};   // Window grid_series_ was last merged at
+    NWSForecast icon_forecast_;
+    std::shared_ptr<const HourlyForecast> hourly_;
     
     std::string last_error_;
     
     // Cached API endpoints from points lookup
     std::string forecast_grid_url_;
     std::string forecast_url_;
+    std::string forecast_hourly_url_;
     std::string stations_url_;
-    std::string nearest_station_id_;
     bool endpoints_initialized_;
+    
+    // On-disk endpoint cache, shared with the background revalidation
+    std::shared_ptr<EndpointCache> endpoint_cache_;
+    int endpoint_revalidate_hours_;
+    std::time_t endpoints_resolved_at_;
+    std::time_t endpoint_retry_after_;   // Earliest retry after a failed revalidation
+    std::future<ResolvedEndpoints> endpoint_revalidation_;
 };
 
 #endif // WEATHER_SERVICE_H
\ No newline at end of file
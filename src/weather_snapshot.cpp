@@ -0,0 +1,122 @@
+#include "weather_snapshot.h"
+#include "binary_io.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'W', 'S', 'N'};
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint16_t) + sizeof(uint32_t);
+
+} // namespace
+
+bool WeatherSnapshot::save(const std::string& path, const WeatherData& data) {
+    BinaryWriter payload;
+    payload.f64(data.temperature_c);
+    payload.i32(data.humidity_percent);
+    payload.f64(data.wind_speed_kmh);
+    payload.i32(data.wind_direction_deg);
+    payload.f64(data.dewpoint_c);
+    payload.f64(data.temperature_max_c);
+    payload.f64(data.temperature_min_c);
+    payload.i32(data.precipitation_chance_percent);
+    payload.str(data.weather_icon);
+    payload.str(data.weather_description);
+    payload.str(data.location);
+    payload.i64(static_cast<int64_t>(data.timestamp));
+
+    BinaryWriter file_data;
+    file_data.bytes.insert(file_data.bytes.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    file_data.u16(FORMAT_VERSION);
+    file_data.u32(static_cast<uint32_t>(payload.bytes.size()));
+    file_data.bytes.insert(file_data.bytes.end(), payload.bytes.begin(), payload.bytes.end());
+    file_data.u32(fnv1a(payload.bytes.data(), payload.bytes.size()));
+
+    std::string tmp_path = path + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Could not write weather snapshot: " << tmp_path << std::endl;
+        return false;
+    }
+
+    bool ok = std::fwrite(file_data.bytes.data(), 1, file_data.bytes.size(), file) == file_data.bytes.size();
+    ok = std::fflush(file) == 0 && ok;
+    ok = fsync(fileno(file)) == 0 && ok;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Could not write weather snapshot: " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::optional<WeatherData> WeatherSnapshot::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[512];
+    size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+
+    if (bytes.size() < HEADER_SIZE + sizeof(uint32_t) ||
+        std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Ignoring invalid weather snapshot: " << path << std::endl;
+        return std::nullopt;
+    }
+
+    BinaryReader header(bytes.data() + sizeof(MAGIC), HEADER_SIZE - sizeof(MAGIC));
+    uint16_t version = header.u16();
+    uint32_t payload_size = header.u32();
+    if (version != FORMAT_VERSION) {
+        std::cout << "Ignoring weather snapshot from format version " << version << std::endl;
+        return std::nullopt;
+    }
+    if (bytes.size() != HEADER_SIZE + payload_size + sizeof(uint32_t)) {
+        std::cerr << "Ignoring truncated weather snapshot: " << path << std::endl;
+        return std::nullopt;
+    }
+
+    const uint8_t* payload_data = bytes.data() + HEADER_SIZE;
+    BinaryReader checksum(payload_data + payload_size, sizeof(uint32_t));
+    if (checksum.u32() != fnv1a(payload_data, payload_size)) {
+        std::cerr << "Ignoring corrupt weather snapshot: " << path << std::endl;
+        return std::nullopt;
+    }
+
+    BinaryReader payload(payload_data, payload_size);
+    WeatherData data;
+    data.temperature_c = payload.f64();
+    data.humidity_percent = payload.i32();
+    data.wind_speed_kmh = payload.f64();
+    data.wind_direction_deg = payload.i32();
+    data.dewpoint_c = payload.f64();
+    data.temperature_max_c = payload.f64();
+    data.temperature_min_c = payload.f64();
+    data.precipitation_chance_percent = payload.i32();
+    data.weather_icon = payload.str();
+    data.weather_description = payload.str();
+    data.location = payload.str();
+    data.timestamp = static_cast<std::time_t>(payload.i64());
+
+    if (!payload.ok()) {
+        std::cerr << "Ignoring malformed weather snapshot: " << path << std::endl;
+        return std::nullopt;
+    }
+
+    data.is_valid = true;
+    data.is_stale = true;
+    return data;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "weather_data.h"
+#include <string>
+#include <optional>
+#include <cstdint>
+
+/**
+ * Last-known-good WeatherData persisted in a compact binary file, so the
+ * display can show real (if stale) numbers at boot before the network is up.
+ *
+ * Layout: "RWSN" magic, format version, payload length, payload, FNV-1a
+ * checksum of the payload. Numbers are little-endian fixed width, strings
+ * are a 16-bit length followed by the bytes.
+ */
+class WeatherSnapshot {
+public:
+    static constexpr uint16_t FORMAT_VERSION = 1;
+
+    // Write data through a temporary file that is synced and renamed over
+    // path, so a power cut never leaves a torn snapshot behind
+    static bool save(const std::string& path, const WeatherData& data);
+
+    // Load a snapshot; nullopt if missing, corrupt or from another version.
+    // The returned data is marked stale.
+    static std::optional<WeatherData> load(const std::string& path);
+};
@@ -29,6 +29,104 @@ struct CharInfo {
     float advance;
 };
 
+// Codepoints below this get a direct-indexed lookup table (ASCII/Latin-1)
+constexpr int DIRECT_COUNT = 256;
+
+// Emit codepoint -> char_data index tables and the glyph_index() lookup.
+// chars must be sorted by codepoint, as pack_characters produces them.
+void write_glyph_index(std::ostream& file, const std::vector<CharInfo>& chars) {
+    auto find_index = [&chars](int codepoint) {
+        for (size_t i = 0; i < chars.size(); i++) {
+            if (chars[i].codepoint == codepoint) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    };
+    
+    int fallback = find_index('?');
+    if (fallback < 0) {
+        fallback = find_index(' ');
+    }
+    
+    file << "// Glyph drawn for codepoints the font lacks: '?', else ' ', else -1\n";
+    file << "constexpr int fallback_index = " << fallback << ";\n\n";
+    
+    std::vector<int> direct(DIRECT_COUNT, fallback);
+    std::vector<std::pair<int, int>> overflow;
+    for (size_t i = 0; i < chars.size(); i++) {
+        if (chars[i].codepoint < DIRECT_COUNT) {
+            direct[chars[i].codepoint] = static_cast<int>(i);
+        } else {
+            overflow.emplace_back(chars[i].codepoint, static_cast<int>(i));
+        }
+    }
+    
+    file << "// char_data index for codepoints below direct_count; missing ones hold fallback_index\n";
+    file << "constexpr uint32_t direct_count = " << DIRECT_COUNT << ";\n";
+    file << "constexpr int16_t direct_index[direct_count] = {\n";
+    for (int i = 0; i < DIRECT_COUNT; i++) {
+        if (i % 16 == 0) file << "    ";
+        file << direct[i];
+        if (i < DIRECT_COUNT - 1) file << ",";
+        if (i % 16 == 15) file << "\n";
+        else file << " ";
+    }
+    file << "};\n\n";
+    
+    file << "// Codepoints from direct_count up, sorted for binary search\n";
+    file << "struct OverflowGlyph {\n";
+    file << "    uint32_t codepoint;\n";
+    file << "    int16_t index;\n";
+    file << "};\n\n";
+    file << "constexpr int overflow_count = " << overflow.size() << ";\n";
+    file << "constexpr OverflowGlyph overflow_index[] = {\n";
+    for (const auto& entry : overflow) {
+        file << "    {" << entry.first << ", " << entry.second << "},\n";
+    }
+    file << "    {0xFFFFFFFF, -1}  // Sentinel; keeps the array non-empty\n";
+    file << "};\n\n";
+    
+    file << "// char_data index for a codepoint, or fallback_index if the font lacks it\n";
+    file << "constexpr int glyph_index(uint32_t codepoint) {\n";
+    file << "    if (codepoint < direct_count) {\n";
+    file << "        return direct_index[codepoint];\n";
+    file << "    }\n";
+    file << "    int lo = 0;\n";
+    file << "    int hi = overflow_count;\n";
+    file << "    while (lo < hi) {\n";
+    file << "        int mid = (lo + hi) / 2;\n";
+    file << "        if (overflow_index[mid].codepoint < codepoint) {\n";
+    file << "            lo = mid + 1;\n";
+    file << "        } else {\n";
+    file << "            hi = mid;\n";
+    file << "        }\n";
+    file << "    }\n";
+    file << "    return (lo < overflow_count && overflow_index[lo].codepoint == codepoint) ? overflow_index[lo].index : fallback_index;\n";
+    file << "}\n\n";
+}
+
+// Emit the Font descriptor that bundles this font for the templated text
+// code in src/text_layout.h. Must follow char_data, glyph_index and
+// atlas_data inside the font's namespace.
+void write_font_descriptor(std::ostream& file, const std::string& ns) {
+    file << "// Atlas, metrics and glyph table for the text code in src/text_layout.h\n";
+    file << "struct Font {\n";
+    file << "    using Glyph = CharData;\n";
+    file << "    static constexpr int size = " << ns << "::size;\n";
+    file << "    static constexpr int line_height = " << ns << "::line_height;\n";
+    file << "    static constexpr int baseline = " << ns << "::baseline;\n";
+    file << "    static constexpr int atlas_width = " << ns << "::atlas_width;\n";
+    file << "    static constexpr int atlas_height = " << ns << "::atlas_height;\n";
+    file << "    static const uint8_t* atlas() { return atlas_data; }\n";
+    file << "    // Glyph for a codepoint, or the fallback glyph; nullptr if the font has neither\n";
+    file << "    static constexpr const Glyph* glyph(uint32_t codepoint) {\n";
+    file << "        int index = glyph_index(codepoint);\n";
+    file << "        return index >= 0 ? &char_data[index] : nullptr;\n";
+    file << "    }\n";
+    file << "};\n\n";
+}
+
 class FontConverter {
 public:
     FontConverter() : font_size_(24), atlas_size_(512) {}
@@ -158,6 +256,8 @@ public:
         
         file << "constexpr int char_count = " << char_info_.size() << ";\n\n";
         
+        write_glyph_index(file, char_info_);
+        
         // Atlas data as C array
         file << "const uint8_t atlas_data[] = {\n";
         for (size_t i = 0; i < atlas_data_.size(); i++) {
@@ -168,7 +268,9 @@ public:
             if (i % 16 == 15) file << "\n";
             else if (i < atlas_data_.size() - 1) file << " ";
         }
-        file << "\n};\n\n";
+        file << std::dec << "\n};\n\n";
+        
+        write_font_descriptor(file, "font_" + font_name_ + "_" + std::to_string(font_size_));
         
         file << "} // namespace font_" << font_name_ << "_" << font_size_ << "\n\n";
         file << "#endif // " << guard_name << "\n";
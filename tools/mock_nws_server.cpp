@@ -0,0 +1,388 @@
+// Mock NWS server - serves recorded api.weather.gov fixtures over plain HTTP
+// so the client, the decoders and the renderer can be exercised offline and
+// under controlled load. Latency, error rate and payload size are all
+// configurable, and a seed makes every run reproducible.
+//
+// Point the app at it with "api_base_url": "http://localhost:8080" in
+// config.json, or run test_nws_api --base-url http://localhost:8080.
+
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <random>
+#include <regex>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <cstdlib>
+
+#ifndef MOCK_NWS_FIXTURES_DIR
+#define MOCK_NWS_FIXTURES_DIR "tools/fixtures/nws"
+#endif
+
+using json = nlohmann::json;
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string fixtures_dir = MOCK_NWS_FIXTURES_DIR;
+    int latency_ms = 0;          // Added to every response
+    int jitter_ms = 0;           // Uniform extra latency on top
+    double error_rate = 0.0;     // Fraction of requests answered with error_status
+    int error_status = 503;
+    int observation_count = 0;   // Features in /observations collections; 0 keeps the fixture's
+    size_t pad_bytes = 0;        // Unused property added to every body
+    int max_age = 0;             // Cache-Control max-age; 0 forces revalidation
+    unsigned seed = 1;
+    bool rebase_times = true;    // Shift fixture timestamps up to the present
+    bool verbose = false;
+};
+
+// Response bodies ready to serve, plus the observation features so
+// collections can be sliced to ?limit=N
+struct Fixtures {
+    std::string points;
+    std::string stations;
+    std::string observation_latest;
+    std::string gridpoint;
+    std::string forecast;
+    std::string forecast_hourly;
+    std::vector<std::string> observation_features;
+};
+
+static httplib::Server* g_server = nullptr;
+
+static void handle_signal(int) {
+    if (g_server) {
+        g_server->stop();
+    }
+}
+
+void print_usage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  --host <addr>          Address to bind (default: 127.0.0.1)\n";
+    std::cout << "  --port <n>             Port to listen on (default: 8080)\n";
+    std::cout << "  --fixtures <dir>       Directory of recorded responses\n";
+    std::cout << "  --latency <ms>         Delay added to every response\n";
+    std::cout << "  --jitter <ms>          Random extra delay, 0..ms\n";
+    std::cout << "  --error-rate <0..1>    Fraction of requests that fail\n";
+    std::cout << "  --error-status <code>  Status for failed requests (default: 503)\n";
+    std::cout << "  --observations <n>     Features per observation collection\n";
+    std::cout << "  --pad <bytes>          Pad every body with an unused property\n";
+    std::cout << "  --max-age <s>          Cache-Control max-age (default: 0)\n";
+    std::cout << "  --seed <n>             Random seed for latency and errors\n";
+    std::cout << "  --freeze-times         Serve fixture timestamps unchanged\n";
+    std::cout << "  --verbose              Log every request\n";
+}
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Could not open fixture: " << path << std::endl;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+// Seconds since the epoch for "YYYY-MM-DDTHH:MM:SS" with an optional
+// "Z" or "+HH:MM" offset
+bool parse_timestamp(const std::smatch& match, std::time_t& out) {
+    std::tm tm = {};
+    tm.tm_year = std::stoi(match[1]) - 1900;
+    tm.tm_mon = std::stoi(match[2]) - 1;
+    tm.tm_mday = std::stoi(match[3]);
+    tm.tm_hour = std::stoi(match[4]);
+    tm.tm_min = std::stoi(match[5]);
+    tm.tm_sec = std::stoi(match[6]);
+    std::time_t t = timegm(&tm);
+    if (match[7].matched && match[7].str() != "Z") {
+        std::string offset = match[7];
+        int seconds = std::stoi(offset.substr(1, 2)) * 3600 + std::stoi(offset.substr(4, 2)) * 60;
+        t += (offset[0] == '+') ? -seconds : seconds;
+    }
+    out = t;
+    return true;
+}
+
+std::string format_timestamp(std::time_t t) {
+    std::tm tm = {};
+    gmtime_r(&t, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S+00:00", &tm);
+    return buffer;
+}
+
+const std::regex& timestamp_pattern() {
+    static const std::regex pattern(
+        R"((\d{4})-(\d{2})-(\d{2})T(\d{2}):(\d{2}):(\d{2})(Z|[+-]\d{2}:\d{2})?)");
+    return pattern;
+}
+
+// Move every ISO-8601 timestamp in text by shift seconds
+std::string shift_timestamps(const std::string& text, std::time_t shift) {
+    if (shift == 0) {
+        return text;
+    }
+    std::string out;
+    out.reserve(text.size());
+    auto begin = std::sregex_iterator(text.begin(), text.end(), timestamp_pattern());
+    size_t last = 0;
+    for (auto it = begin; it != std::sregex_iterator(); ++it) {
+        std::time_t t = 0;
+        parse_timestamp(*it, t);
+        out.append(text, last, it->position() - last);
+        out += format_timestamp(t + shift);
+        last = it->position() + it->length();
+    }
+    out.append(text, last, std::string::npos);
+    return out;
+}
+
+std::string pad_body(const std::string& body, size_t pad_bytes) {
+    if (pad_bytes == 0 || body.empty() || body[0] != '{') {
+        return body;
+    }
+    // Placed first so decoders have to skip it before reaching the data
+    return "{\"padding\":\"" + std::string(pad_bytes, 'x') + "\"," + body.substr(1);
+}
+
+bool load_fixtures(const Options& options, Fixtures& fixtures) {
+    const std::string& dir = options.fixtures_dir;
+    std::string observations;
+    if (!read_file(dir + "/points.json", fixtures.points) ||
+        !read_file(dir + "/stations.json", fixtures.stations) ||
+        !read_file(dir + "/observation_latest.json", fixtures.observation_latest) ||
+        !read_file(dir + "/observations.json", observations) ||
+        !read_file(dir + "/gridpoint.json", fixtures.gridpoint) ||
+        !read_file(dir + "/forecast.json", fixtures.forecast) ||
+        !read_file(dir + "/forecast_hourly.json", fixtures.forecast_hourly)) {
+        return false;
+    }
+
+    // The latest observation marks when the fixtures were recorded. Shift
+    // by whole hours so it lands within the last hour and the forecast
+    // intervals cover the present.
+    std::time_t shift = 0;
+    if (options.rebase_times) {
+        std::string recorded = json::parse(fixtures.observation_latest)["properties"]["timestamp"];
+        std::smatch match;
+        std::time_t recorded_at = 0;
+        if (std::regex_search(recorded, match, timestamp_pattern()) &&
+            parse_timestamp(match, recorded_at)) {
+            shift = ((std::time(nullptr) - recorded_at) / 3600) * 3600;
+        }
+        std::cout << "Shifting fixture timestamps by " << shift / 3600 << " hours" << std::endl;
+    }
+
+    for (std::string* body : {&fixtures.points, &fixtures.stations, &fixtures.observation_latest,
+                              &fixtures.gridpoint, &fixtures.forecast, &fixtures.forecast_hourly}) {
+        *body = pad_body(shift_timestamps(*body, shift), options.pad_bytes);
+    }
+
+    json collection = json::parse(shift_timestamps(observations, shift));
+    const json& features = collection["features"];
+    if (!features.is_array() || features.empty()) {
+        std::cerr << "observations.json has no features" << std::endl;
+        return false;
+    }
+    size_t count = options.observation_count > 0 ? static_cast<size_t>(options.observation_count)
+                                                 : features.size();
+    // Recorded features are repeated to reach larger collection sizes
+    for (size_t i = 0; i < count; i++) {
+        fixtures.observation_features.push_back(features[i % features.size()].dump());
+    }
+    return true;
+}
+
+class MockNWSServer {
+public:
+    MockNWSServer(const Options& options, Fixtures fixtures)
+        : options_(options)
+        , fixtures_(std::move(fixtures))
+        , rng_(options.seed)
+        , requests_(0)
+        , errors_(0)
+        , not_modified_(0)
+    {
+    }
+
+    void registerRoutes(httplib::Server& server) {
+        const std::string grid = R"(/gridpoints/\w+/\d+,\d+)";
+        server.Get(R"(/points/[-0-9.]+,[-0-9.]+)", fixed(fixtures_.points));
+        server.Get(grid + "/stations", fixed(fixtures_.stations));
+        server.Get(grid + "/forecast/hourly", fixed(fixtures_.forecast_hourly));
+        server.Get(grid + "/forecast", fixed(fixtures_.forecast));
+        server.Get(grid, fixed(fixtures_.gridpoint));
+        server.Get(R"(/stations/\w+/observations/latest)", fixed(fixtures_.observation_latest));
+        server.Get(R"(/stations/\w+/observations)",
+                   [this](const httplib::Request& req, httplib::Response& res) {
+                       respond(req, res, observationCollection(req));
+                   });
+    }
+
+    void printStats() const {
+        std::cout << "Served " << requests_ << " requests, "
+                  << errors_ << " injected errors, "
+                  << not_modified_ << " not modified" << std::endl;
+    }
+
+private:
+    httplib::Server::Handler fixed(const std::string& body) {
+        return [this, &body](const httplib::Request& req, httplib::Response& res) {
+            respond(req, res, body);
+        };
+    }
+
+    std::string observationCollection(const httplib::Request& req) {
+        size_t limit = fixtures_.observation_features.size();
+        if (req.has_param("limit")) {
+            limit = std::min<size_t>(limit, std::strtoul(req.get_param_value("limit").c_str(), nullptr, 10));
+        }
+        std::string body = "{\"type\":\"FeatureCollection\",\"features\":[";
+        for (size_t i = 0; i < limit; i++) {
+            if (i > 0) {
+                body += ',';
+            }
+            body += fixtures_.observation_features[i];
+        }
+        body += "]}";
+        return pad_body(body, options_.pad_bytes);
+    }
+
+    void respond(const httplib::Request& req, httplib::Response& res, const std::string& body) {
+        requests_++;
+
+        int delay_ms = options_.latency_ms;
+        bool fail = false;
+        {
+            std::lock_guard<std::mutex> lock(rng_mutex_);
+            if (options_.jitter_ms > 0) {
+                delay_ms += std::uniform_int_distribution<int>(0, options_.jitter_ms)(rng_);
+            }
+            fail = std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < options_.error_rate;
+        }
+        if (delay_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+        }
+
+        if (options_.verbose) {
+            std::cout << "GET " << req.path << (fail ? " -> injected error" : "") << std::endl;
+        }
+
+        if (fail) {
+            errors_++;
+            res.status = options_.error_status;
+            res.set_content("{\"title\":\"Unexpected Problem\",\"status\":" +
+                            std::to_string(options_.error_status) + "}",
+                            "application/problem+json");
+            return;
+        }
+
+        char etag[24];
+        std::snprintf(etag, sizeof(etag), "\"%016zx\"", std::hash<std::string>()(body));
+        res.set_header("ETag", etag);
+        res.set_header("Cache-Control", "public, max-age=" + std::to_string(options_.max_age));
+
+        if (req.get_header_value("If-None-Match") == etag) {
+            not_modified_++;
+            res.status = 304;
+            return;
+        }
+        res.set_content(body, "application/geo+json");
+    }
+
+    Options options_;
+    Fixtures fixtures_;
+
+    std::mutex rng_mutex_;
+    std::mt19937 rng_;
+
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> errors_;
+    std::atomic<uint64_t> not_modified_;
+};
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--host" && has_value) {
+            options.host = argv[++i];
+        } else if (arg == "--port" && has_value) {
+            options.port = std::atoi(argv[++i]);
+        } else if (arg == "--fixtures" && has_value) {
+            options.fixtures_dir = argv[++i];
+        } else if (arg == "--latency" && has_value) {
+            options.latency_ms = std::atoi(argv[++i]);
+        } else if (arg == "--jitter" && has_value) {
+            options.jitter_ms = std::atoi(argv[++i]);
+        } else if (arg == "--error-rate" && has_value) {
+            options.error_rate = std::atof(argv[++i]);
+        } else if (arg == "--error-status" && has_value) {
+            options.error_status = std::atoi(argv[++i]);
+        } else if (arg == "--observations" && has_value) {
+            options.observation_count = std::atoi(argv[++i]);
+        } else if (arg == "--pad" && has_value) {
+            options.pad_bytes = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--max-age" && has_value) {
+            options.max_age = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--freeze-times") {
+            options.rebase_times = false;
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Fixtures fixtures;
+    try {
+        if (!load_fixtures(options, fixtures)) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load fixtures: " << e.what() << std::endl;
+        return 1;
+    }
+
+    MockNWSServer mock(options, std::move(fixtures));
+    httplib::Server server;
+    mock.registerRoutes(server);
+
+    g_server = &server;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::cout << "Mock NWS server on http://" << options.host << ":" << options.port
+              << " (fixtures: " << options.fixtures_dir << ")" << std::endl;
+    if (!server.listen(options.host, options.port)) {
+        std::cerr << "Failed to listen on " << options.host << ":" << options.port << std::endl;
+        return 1;
+    }
+
+    mock.printStats();
+    return 0;
+}
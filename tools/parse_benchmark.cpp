@@ -0,0 +1,318 @@
+// Parse benchmark - compares the streaming schema decoders against building
+// a full nlohmann::json DOM for the NWS gridpoint and observation payloads,
+// and the memory retained by the hourly columnar store against keeping the
+// hourly JSON around. Reports parse time and heap usage for each path.
+
+#include "nws_decoders.h"
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+
+// Heap accounting: every allocation carries a small header with its size so
+// current and peak usage can be tracked without platform-specific hooks.
+static size_t g_heap_current = 0;
+static size_t g_heap_peak = 0;
+
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + HEADER_SIZE);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+    g_heap_current += size;
+    if (g_heap_current > g_heap_peak) {
+        g_heap_peak = g_heap_current;
+    }
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - HEADER_SIZE;
+    g_heap_current -= *static_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+// Synthetic gridpoint payload shaped like /gridpoints/{office}/{x},{y}
+std::string make_gridpoint_payload(int values_per_series) {
+    static const char* series[] = {
+        "temperature", "dewpoint", "maxTemperature", "minTemperature", "relativeHumidity",
+        "apparentTemperature", "heatIndex", "windChill", "skyCover", "windDirection",
+        "windSpeed", "windGust", "probabilityOfPrecipitation", "quantitativePrecipitation",
+        "iceAccumulation", "snowfallAmount", "snowLevel", "ceilingHeight", "visibility",
+        "transportWindSpeed", "transportWindDirection", "mixingHeight", "hainesIndex",
+        "lightningActivityLevel", "twentyFootWindSpeed", "twentyFootWindDirection",
+        "grasslandFireDangerIndex", "probabilityOfThunder", "davisStabilityIndex",
+        "atmosphericDispersionIndex", "lowVisibilityOccurrenceRiskIndex", "stability"
+    };
+
+    std::ostringstream out;
+    out << "{\"@context\":[\"https://geojson.org/geojson-ld/geojson-context.jsonld\"],"
+        << "\"id\":\"https://api.weather.gov/gridpoints/ALY/59,14\",\"type\":\"Feature\","
+        << "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+    for (int i = 0; i < 5; i++) {
+        out << (i ? "," : "") << "[-73.93" << i << ",44.1" << i << "]";
+    }
+    out << "]]},\"properties\":{\"updateTime\":\"2024-06-01T12:00:00+00:00\","
+        << "\"validTimes\":\"2024-06-01T06:00:00+00:00/P7DT19H\",\"elevation\":{\"unitCode\":\"wmoUnit:m\",\"value\":1629.1}";
+
+    for (const char* name : series) {
+        out << ",\"" << name << "\":{\"uom\":\"wmoUnit:degC\",\"values\":[";
+        for (int i = 0; i < values_per_series; i++) {
+            out << (i ? "," : "") << "{\"validTime\":\"2024-06-0" << (1 + i / 24) % 10
+                << "T" << (i % 24 < 10 ? "0" : "") << i % 24 << ":00:00+00:00/PT1H\",\"value\":"
+                << (i % 37) * 0.5 << "}";
+        }
+        out << "]}";
+    }
+
+    out << ",\"weather\":{\"values\":[";
+    for (int i = 0; i < values_per_series; i++) {
+        out << (i ? "," : "") << "{\"validTime\":\"2024-06-01T00:00:00+00:00/PT3H\",\"value\":["
+            << "{\"coverage\":\"chance\",\"weather\":\"rain_showers\",\"intensity\":\"light\","
+            << "\"visibility\":{\"unitCode\":\"wmoUnit:km\",\"value\":null},\"attributes\":[]}]}";
+    }
+    out << "]}}}";
+    return out.str();
+}
+
+// Synthetic observation history shaped like /stations/{id}/observations,
+// where only the last feature has a QC-valid temperature
+std::string make_observation_payload(int features) {
+    std::ostringstream out;
+    out << "{\"type\":\"FeatureCollection\",\"features\":[";
+    for (int i = 0; i < features; i++) {
+        bool valid = (i == features / 2);
+        out << (i ? "," : "") << "{\"id\":\"obs" << i << "\",\"type\":\"Feature\","
+            << "\"geometry\":{\"type\":\"Point\",\"coordinates\":[-73.9,44.1]},"
+            << "\"properties\":{\"timestamp\":\"2024-06-01T12:00:00+00:00\","
+            << "\"textDescription\":\"Cloudy\",\"rawMessage\":\"KXYZ 011200Z AUTO 27010KT 10SM OVC040 12/08 A2992\","
+            << "\"temperature\":{\"unitCode\":\"wmoUnit:degC\",\"value\":" << (valid ? "12.5" : "null")
+            << ",\"qualityControl\":\"" << (valid ? "V" : "Z") << "\"},"
+            << "\"dewpoint\":{\"unitCode\":\"wmoUnit:degC\",\"value\":8.1,\"qualityControl\":\"V\"},"
+            << "\"windDirection\":{\"unitCode\":\"wmoUnit:degree_(angle)\",\"value\":270,\"qualityControl\":\"V\"},"
+            << "\"windSpeed\":{\"unitCode\":\"wmoUnit:km_h-1\",\"value\":18.5,\"qualityControl\":\"V\"},"
+            << "\"barometricPressure\":{\"unitCode\":\"wmoUnit:Pa\",\"value\":101320,\"qualityControl\":\"V\"},"
+            << "\"relativeHumidity\":{\"unitCode\":\"wmoUnit:percent\",\"value\":76.3,\"qualityControl\":\"V\"},"
+            << "\"cloudLayers\":[{\"base\":{\"unitCode\":\"wmoUnit:m\",\"value\":1220},\"amount\":\"OVC\"}]}}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+// Synthetic /forecast/hourly payload (the API returns 156 periods)
+std::string make_hourly_payload(int periods) {
+    static const char* directions[] = {"N", "NE", "E", "SE", "S", "SW", "W", "NW"};
+    std::ostringstream out;
+    out << "{\"type\":\"Feature\",\"properties\":{\"units\":\"us\",\"forecastGenerator\":\"HourlyForecastGenerator\","
+        << "\"generatedAt\":\"2024-06-01T12:00:00+00:00\",\"periods\":[";
+    for (int i = 0; i < periods; i++) {
+        int hour = (6 + i) % 24;
+        int day = 1 + (6 + i) / 24;
+        out << (i ? "," : "") << "{\"number\":" << i + 1 << ",\"name\":\"\","
+            << "\"startTime\":\"2024-06-" << (day < 10 ? "0" : "") << day << "T" << (hour < 10 ? "0" : "") << hour << ":00:00-05:00\","
+            << "\"endTime\":\"2024-06-" << (day < 10 ? "0" : "") << day << "T" << (hour < 10 ? "0" : "") << hour << ":59:59-05:00\","
+            << "\"isDaytime\":" << (hour >= 6 && hour < 18 ? "true" : "false") << ","
+            << "\"temperature\":" << 60 + (i % 20) << ",\"temperatureUnit\":\"F\",\"temperatureTrend\":\"\","
+            << "\"probabilityOfPrecipitation\":{\"unitCode\":\"wmoUnit:percent\",\"value\":" << (i * 7) % 100 << "},"
+            << "\"dewpoint\":{\"unitCode\":\"wmoUnit:degC\",\"value\":12.2},"
+            << "\"relativeHumidity\":{\"unitCode\":\"wmoUnit:percent\",\"value\":" << 40 + (i % 50) << "},"
+            << "\"windSpeed\":\"" << 5 + (i % 10) << " mph\",\"windDirection\":\"" << directions[i % 8] << "\","
+            << "\"icon\":\"https://api.weather.gov/icons/land/day/rain_showers," << (i * 7) % 100 << "?size=small\","
+            << "\"shortForecast\":\"Chance Rain Showers\",\"detailedForecast\":\"\"}";
+    }
+    out << "]}}";
+    return out.str();
+}
+
+// Heap retained by whatever make() returns, plus the time to read every
+// hour's temperature through read()
+template <typename Make, typename Read>
+void run_retained(const char* name, const std::string& body, Make make, Read read) {
+    size_t baseline = g_heap_current;
+    auto kept = make(body);
+    size_t retained = g_heap_current - baseline;
+
+    constexpr int READ_PASSES = 1000;
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < READ_PASSES; pass++) {
+        sum += read(kept);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / READ_PASSES;
+
+    std::printf("  %-22s %10.1f KB retained  %8.2f us/full scan%s\n",
+                name, retained / 1024.0, us, sum > 0.0 ? "" : "  (INVALID RESULT)");
+}
+
+// The same series index built from a full DOM instead of the event stream
+bool dom_gridpoint(const std::string& body) {
+    GridpointSeries series;
+    auto json = nlohmann::json::parse(body);
+    const auto& props = json["properties"];
+
+    auto index = [&](const char* field, TimeSeries& out) {
+        for (const auto& item : props[field]["values"]) {
+            int64_t start, end;
+            if (!item["value"].is_null() && parseValidTime(item["validTime"].get<std::string>(), start, end)) {
+                out.append(start, end, item["value"].get<double>());
+            }
+        }
+    };
+    index("temperature", series.temperature);
+    index("maxTemperature", series.max_temperature);
+    index("minTemperature", series.min_temperature);
+    index("probabilityOfPrecipitation", series.precipitation_chance);
+    index("skyCover", series.sky_cover);
+
+    for (const auto& item : props["weather"]["values"]) {
+        int64_t start, end;
+        if (!parseValidTime(item["validTime"].get<std::string>(), start, end)) {
+            continue;
+        }
+        const auto& first = item["value"][0];
+        series.weather.append(start, end,
+                              first["weather"].is_string() ? first["weather"].get<std::string>() : "",
+                              first["intensity"].is_string() ? first["intensity"].get<std::string>() : "");
+    }
+
+    series.finalize();
+    return !series.temperature.values.empty();
+}
+
+NWSObservation dom_observation(const std::string& body) {
+    NWSObservation result;
+    auto json = nlohmann::json::parse(body);
+    for (const auto& feature : json["features"]) {
+        const auto& props = feature["properties"];
+        if (props["temperature"]["qualityControl"] == "V") {
+            result.valid = true;
+            result.timestamp = props["timestamp"].get<std::string>();
+            result.temperature_celsius = props["temperature"]["value"].get<double>();
+            break;
+        }
+    }
+    return result;
+}
+
+template <typename Fn>
+void run_case(const char* name, const std::string& body, int iterations, Fn fn) {
+    size_t baseline = g_heap_current;
+    g_heap_peak = g_heap_current;
+
+    auto start = std::chrono::steady_clock::now();
+    bool valid = true;
+    for (int i = 0; i < iterations; i++) {
+        valid = fn(body) && valid;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    double peak_kb = (g_heap_peak - baseline) / 1024.0;
+
+    std::printf("  %-22s %9.2f ms/parse  %10.1f KB peak heap%s\n",
+                name, ms, peak_kb, valid ? "" : "  (INVALID RESULT)");
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 20;
+    int values_per_series = 200;
+    int observation_features = 250;
+    std::string gridpoint_file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else if (arg == "--values" && i + 1 < argc) {
+            values_per_series = std::atoi(argv[++i]);
+        } else if (arg == "--gridpoint" && i + 1 < argc) {
+            gridpoint_file = argv[++i];
+        } else {
+            std::cout << "Usage: parse_benchmark [--iterations N] [--values N] [--gridpoint file.json]\n";
+            std::cout << "  --values     Values per gridpoint series in the synthetic payload\n";
+            std::cout << "  --gridpoint  Use a recorded /gridpoints response instead\n";
+            return 1;
+        }
+    }
+
+    std::string gridpoint;
+    if (!gridpoint_file.empty()) {
+        std::ifstream file(gridpoint_file);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << gridpoint_file << std::endl;
+            return 1;
+        }
+        std::stringstream ss;
+        ss << file.rdbuf();
+        gridpoint = ss.str();
+    } else {
+        gridpoint = make_gridpoint_payload(values_per_series);
+    }
+    std::string observations = make_observation_payload(observation_features);
+
+    std::printf("Gridpoint payload: %zu bytes, %d iterations\n", gridpoint.size(), iterations);
+    run_case("DOM (nlohmann::json)", gridpoint, iterations, [](const std::string& body) {
+        return dom_gridpoint(body);
+    });
+    run_case("Streaming decoder", gridpoint, iterations, [](const std::string& body) {
+        GridpointDecoder decoder;
+        return decoder.parse(body) && !decoder.series.temperature.values.empty();
+    });
+
+    std::printf("Observation payload: %zu bytes, %d features\n", observations.size(), observation_features);
+    run_case("DOM (nlohmann::json)", observations, iterations, [](const std::string& body) {
+        return dom_observation(body).valid;
+    });
+    run_case("Streaming decoder", observations, iterations, [](const std::string& body) {
+        ObservationDecoder decoder;
+        return decoder.parse(body) && decoder.observation.valid;
+    });
+
+    std::string hourly = make_hourly_payload(156);
+    std::printf("Hourly payload: %zu bytes, 156 periods\n", hourly.size());
+    run_retained("DOM (nlohmann::json)", hourly,
+        [](const std::string& body) { return nlohmann::json::parse(body); },
+        [](const nlohmann::json& json) {
+            double sum = 0.0;
+            for (const auto& period : json["properties"]["periods"]) {
+                sum += period["temperature"].get<double>();
+            }
+            return sum;
+        });
+    run_retained("Columnar store", hourly,
+        [](const std::string& body) {
+            HourlyForecastDecoder decoder([](const std::string&) { return 9; });
+            decoder.parse(body);
+            HourlyForecast store = std::move(decoder.hourly);
+            store.shrinkToFit();
+            return store;
+        },
+        [](const HourlyForecast& store) {
+            double sum = 0.0;
+            for (int16_t t : store.temperatureDeciC()) {
+                if (t != HourlyForecast::MISSING_I16) {
+                    sum += t / 10.0;
+                }
+            }
+            return sum;
+        });
+
+    return 0;
+}
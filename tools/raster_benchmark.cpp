@@ -0,0 +1,170 @@
+// Raster benchmark - compares DisplayRenderer's span-based primitives, which
+// clip once and fill whole rows, against the per-pixel path they replaced
+// (a set_pixel call, with its bounds check, for every pixel). Each case draws
+// the same pixels both ways and checks that the frames match.
+
+#include "display_renderer.h"
+#include "weather_icons_large.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Six panels shaped like the WeatherApp::render_weather layout
+static constexpr int BORDER = 3;
+static constexpr int PANEL_W = 195;
+static constexpr int PANEL_H = 205;
+
+static void panel_origin(int index, int& x, int& y) {
+    x = BORDER + (index % 3) * (PANEL_W + BORDER + 1);
+    y = BORDER + (index / 3) * (PANEL_H + BORDER + 2);
+}
+
+// Per-pixel reference implementations
+static void pixel_rectangle(DisplayRenderer& r, int x, int y, int w, int h, uint8_t color) {
+    for (int dy = 0; dy < h; dy++) {
+        for (int dx = 0; dx < w; dx++) {
+            r.set_pixel(x + dx, y + dy, color);
+        }
+    }
+}
+
+static void pixel_panel_border(DisplayRenderer& r, int px, int py, int pw, int ph) {
+    for (int i = 0; i < 3; i++) {
+        for (int x = px - i; x < px + pw + i; x++) {
+            r.set_pixel(x, py - i, DisplayRenderer::BLACK);
+            r.set_pixel(x, py + ph + i, DisplayRenderer::BLACK);
+        }
+        for (int y = py - i; y < py + ph + i; y++) {
+            r.set_pixel(px - i, y, DisplayRenderer::BLACK);
+            r.set_pixel(px + pw + i, y, DisplayRenderer::BLACK);
+        }
+    }
+}
+
+static void pixel_icon(DisplayRenderer& r, int x, int y, const std::string& name) {
+    const auto* icon = weather_icons::get_icon(name);
+    if (!icon) {
+        return;
+    }
+    int icon_x = x + (PANEL_W - icon->width) / 2;
+    int icon_y = y + (PANEL_H - icon->height) / 2;
+    for (int iy = 0; iy < icon->height; iy++) {
+        for (int ix = 0; ix < icon->width; ix++) {
+            uint8_t pixel = icon->data[iy * icon->width + ix];
+            if (pixel != DisplayRenderer::WHITE) {
+                r.set_pixel(icon_x + ix, icon_y + iy, pixel);
+            }
+        }
+    }
+}
+
+// The non-text part of a weather frame: borders, icon and separators
+static void layout_pixels(DisplayRenderer& r) {
+    r.clear(DisplayRenderer::WHITE);
+    for (int i = 0; i < 6; i++) {
+        int x, y;
+        panel_origin(i, x, y);
+        pixel_panel_border(r, x, y, PANEL_W, PANEL_H);
+        if (i > 0) {
+            pixel_rectangle(r, x + 10, y + 50, PANEL_W - 20, 2, DisplayRenderer::BLACK);
+        }
+    }
+    pixel_icon(r, BORDER, BORDER, "01");
+}
+
+static void layout_spans(DisplayRenderer& r) {
+    r.clear(DisplayRenderer::WHITE);
+    for (int i = 0; i < 6; i++) {
+        int x, y;
+        panel_origin(i, x, y);
+        r.draw_panel_border(x, y, PANEL_W, PANEL_H);
+        if (i > 0) {
+            r.draw_rectangle(x + 10, y + 50, PANEL_W - 20, 2, DisplayRenderer::BLACK);
+        }
+    }
+    r.draw_weather_icon(BORDER, BORDER, PANEL_W, PANEL_H, "01");
+}
+
+static double time_us(DisplayRenderer& r, int iterations, const std::function<void(DisplayRenderer&)>& draw) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        draw(r);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+static bool same_frame(const DisplayRenderer& a, const DisplayRenderer& b) {
+    return std::equal(a.packed_pixels(), a.packed_pixels() + a.packed_size(), b.packed_pixels());
+}
+
+static void run_case(const char* name, int iterations,
+                     const std::function<void(DisplayRenderer&)>& per_pixel,
+                     const std::function<void(DisplayRenderer&)>& spans) {
+    DisplayRenderer pixel_renderer;
+    DisplayRenderer span_renderer;
+    double pixel_us = time_us(pixel_renderer, iterations, per_pixel);
+    double span_us = time_us(span_renderer, iterations, spans);
+
+    std::printf("  %-24s %9.1f us per-pixel  %9.1f us spans  %6.1fx%s\n",
+                name, pixel_us, span_us, pixel_us / span_us,
+                same_frame(pixel_renderer, span_renderer) ? "" : "  (FRAMES DIFFER)");
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 200;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else {
+            std::printf("Usage: raster_benchmark [--iterations N]\n");
+            return 1;
+        }
+    }
+
+    std::printf("Raster primitives, %dx%d packed 4bpp, %d iterations\n",
+                DisplayRenderer::SCREEN_WIDTH, DisplayRenderer::SCREEN_HEIGHT, iterations);
+
+    run_case("Fill panel rect", iterations,
+        [](DisplayRenderer& r) { pixel_rectangle(r, 201, 3, PANEL_W, PANEL_H, DisplayRenderer::BLUE); },
+        [](DisplayRenderer& r) { r.draw_rectangle(201, 3, PANEL_W, PANEL_H, DisplayRenderer::BLUE); });
+    run_case("Fill clipped rect", iterations,
+        [](DisplayRenderer& r) { pixel_rectangle(r, -100, -100, 800, 300, DisplayRenderer::RED); },
+        [](DisplayRenderer& r) { r.draw_rectangle(-100, -100, 800, 300, DisplayRenderer::RED); });
+    run_case("Panel borders x6", iterations,
+        [](DisplayRenderer& r) {
+            for (int i = 0; i < 6; i++) {
+                int x, y;
+                panel_origin(i, x, y);
+                pixel_panel_border(r, x, y, PANEL_W, PANEL_H);
+            }
+        },
+        [](DisplayRenderer& r) {
+            for (int i = 0; i < 6; i++) {
+                int x, y;
+                panel_origin(i, x, y);
+                r.draw_panel_border(x, y, PANEL_W, PANEL_H);
+            }
+        });
+    run_case("Weather icon", iterations,
+        [](DisplayRenderer& r) { pixel_icon(r, BORDER, BORDER, "01"); },
+        [](DisplayRenderer& r) { r.draw_weather_icon(BORDER, BORDER, PANEL_W, PANEL_H, "01"); });
+    run_case("Frame layout", iterations, layout_pixels, layout_spans);
+
+    // Text has no per-pixel counterpart left to compare against
+    DisplayRenderer text_renderer;
+    double text_us = time_us(text_renderer, iterations, [](DisplayRenderer& r) {
+        r.draw_text_centered(201, 60, PANEL_W, 80, "72°F", DisplayRenderer::BLACK);
+        r.draw_text_centered(201, 10, PANEL_W, 30, "Currently", DisplayRenderer::BLACK);
+    });
+    std::printf("  %-24s %9.1f us spans\n", "Text (2 strings)", text_us);
+
+    return 0;
+}